@@ -0,0 +1,503 @@
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <random>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <filesystem>
+#include <system_error>
+
+#include <malloc.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include <benchmark/benchmark.h>
+
+#include "../include/Graph.h"
+#include "../include/NetworkGenerator.h"
+
+/**
+ * @brief The allocations of the process, counted by the replaced operator new: their number, the bytes in use and the
+ * most bytes in use since the last reset.
+ */
+static std::atomic<long long> numAllocations{0};
+static std::atomic<long long> bytesInUse{0};
+static std::atomic<long long> peakBytesInUse{0};
+
+void* operator new(std::size_t n) {
+    void* p = std::malloc(n == 0 ? 1 : n);
+    if (p == nullptr) throw std::bad_alloc();
+    long long size = (long long) malloc_usable_size(p);
+    numAllocations.fetch_add(1, std::memory_order_relaxed);
+    long long inUse = bytesInUse.fetch_add(size, std::memory_order_relaxed) + size;
+    long long peak = peakBytesInUse.load(std::memory_order_relaxed);
+    while (inUse > peak && !peakBytesInUse.compare_exchange_weak(peak, inUse, std::memory_order_relaxed));
+    return p;
+}
+
+void operator delete(void* p) noexcept {
+    if (p == nullptr) return;
+    bytesInUse.fetch_sub((long long) malloc_usable_size(p), std::memory_order_relaxed);
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    operator delete(p);
+}
+
+/**
+ * @brief Reports the allocations made between Start and Stop to the benchmark library: their number, the bytes
+ * allocated and the most bytes in use above the ones in use at Start.
+ */
+class AllocationCounter : public benchmark::MemoryManager {
+    long long startAllocations = 0;
+    long long startBytes = 0;
+
+public:
+    void Start() override {
+        startAllocations = numAllocations.load();
+        startBytes = bytesInUse.load();
+        peakBytesInUse = startBytes;
+    }
+
+    void Stop(Result& result) override {
+        result.num_allocs = numAllocations.load() - startAllocations;
+        result.max_bytes_used = peakBytesInUse.load() - startBytes;
+        result.net_heap_growth = bytesInUse.load() - startBytes;
+    }
+
+    void Stop(Result* result) override {
+        Stop(*result);
+    }
+};
+
+/**
+ * @brief The number of pairs of stations queried in turns by each benchmark.
+ */
+static const int NUM_PAIRS = 64;
+
+/**
+ * @brief A network under test and the stations it is queried with.
+ */
+struct Network {
+    std::unique_ptr<Graph> graph;
+    std::vector<std::pair<std::string, std::string>> pairs;
+    std::vector<std::pair<std::string, std::string>> lines;
+    bool loaded = false;
+};
+
+/**
+ * @brief Gets the parameters of the synthetic network with the given number of stations: a mesh (the tree of lines of
+ * the dataset has a single path between most stations, so its flows are trivial) with the other defaults of
+ * GeneratorOptions.
+ */
+static GeneratorOptions syntheticOptions(int numStations) {
+    GeneratorOptions options;
+    options.numStations = numStations;
+    options.topology = TOPOLOGY_MESH;
+    options.seed = (unsigned) numStations;
+    return options;
+}
+
+/**
+ * @brief Gets the directory of every file the benchmarks use or write (the copy of the dataset, the synthetic networks,
+ * the binary datasets and the route indexes), in the temporary directory of the system. Removed when main ends.
+ *
+ * @return The directory.
+ */
+static const std::filesystem::path& fixtureDirectory() {
+    static const std::filesystem::path directory =
+            std::filesystem::temp_directory_path() / ("da-benchmarks-" + std::to_string(getpid()));
+    return directory;
+}
+
+/**
+ * @brief Gets the dataset directory of a benchmark, copying the dataset or writing the synthetic network into the
+ * fixture directory the first time it is used, so the dataset directory itself is never written.
+ *
+ * @param numStations 0 for the dataset, the number of stations of a synthetic network otherwise.
+ * @return The directory.
+ */
+static std::string datasetDirectoryOf(int numStations) {
+    std::filesystem::path directory =
+            fixtureDirectory() / (numStations == 0 ? "dataset" : "synthetic-" + std::to_string(numStations));
+    static std::map<int, bool> written;
+    if (written[numStations]) return directory.string();
+
+    if (numStations == 0) {
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+        for (const std::string& name : {STATIONS_FILE_NAME, NETWORK_FILE_NAME}) {
+            if (!error) std::filesystem::copy_file(std::filesystem::path(DATASET_DIRECTORY) / name, directory / name, error);
+        }
+        written[numStations] = !error;
+    }
+    else written[numStations] = NetworkGenerator(syntheticOptions(numStations)).write(directory.string());
+    return directory.string();
+}
+
+/**
+ * @brief Gets a network, loading it the first time.
+ *
+ * @param numStations 0 for the dataset, the number of stations of a synthetic network otherwise.
+ * @return The network. Not loaded if the dataset could not be read.
+ */
+static Network& getNetwork(int numStations) {
+    static std::map<int, Network> networks;
+    Network& network = networks[numStations];
+    if (network.graph != nullptr) return network;
+
+    network.graph.reset(new Graph());
+    Graph& graph = *network.graph;
+    if (numStations == 0) {
+        graph.setDatasetDirectory(datasetDirectoryOf(0));
+        graph.fill();
+    }
+    else NetworkGenerator(syntheticOptions(numStations)).fill(graph);
+    graph.setCacheCapacity(0);
+
+    const std::vector<Station*>& stations = graph.getStationSet();
+    if (stations.size() < 2) return network;
+    network.loaded = true;
+
+    //os pares sao tirados diretamente do gerador para serem os mesmos com qualquer biblioteca
+    std::mt19937 rng(42);
+    while ((int) network.pairs.size() < NUM_PAIRS) {
+        Station* s = stations[rng() % stations.size()];
+        Station* t = stations[rng() % stations.size()];
+        if (s != t) network.pairs.emplace_back(s->getName(), t->getName());
+    }
+    while ((int) network.lines.size() < NUM_PAIRS) {
+        Station* s = stations[rng() % stations.size()];
+        if (s->getAdj().empty()) continue;
+        network.lines.emplace_back(s->getName(), s->getAdj()[rng() % s->getAdj().size()]->getDest()->getName());
+    }
+    return network;
+}
+
+/**
+ * @brief Gets the network of a benchmark, skipping the benchmark if it could not be loaded.
+ */
+static Network* networkOf(benchmark::State& state) {
+    Network& network = getNetwork((int) state.range(0));
+    if (!network.loaded) {
+        state.SkipWithError("the dataset could not be read");
+        return nullptr;
+    }
+    return &network;
+}
+
+/**
+ * @brief Adds and removes a station with the timer paused, so the next query rebuilds the snapshot and every structure
+ * derived from it (the Gomory-Hu tree, the leaves, the route index).
+ */
+static void invalidate(benchmark::State& state, Graph& graph) {
+    state.PauseTiming();
+    graph.addStation("benchmark", "benchmark", "benchmark", "benchmark", "benchmark");
+    graph.removeStation(graph.findStation("benchmark"));
+    state.ResumeTiming();
+}
+
+/**
+ * @brief Reports the peak resident set size of the process.
+ */
+static void reportPeakMemory(benchmark::State& state) {
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    state.counters["peak_rss_mb"] = (double) usage.ru_maxrss / 1024.0;
+}
+
+static void BM_ReadNetwork(benchmark::State& state) {
+    std::string directory = datasetDirectoryOf((int) state.range(0));
+    for (auto _ : state) {
+        Graph graph;
+        graph.setDatasetDirectory(directory);
+        graph.readStations();
+        graph.readNetwork();
+        if (graph.getStationSet().empty()) {
+            state.SkipWithError("the dataset could not be read");
+            break;
+        }
+        benchmark::DoNotOptimize(graph.getStationSet().data());
+    }
+    reportPeakMemory(state);
+}
+BENCHMARK(BM_ReadNetwork)->Arg(0)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond);
+
+static void BM_Fill(benchmark::State& state) {
+    std::string directory = datasetDirectoryOf((int) state.range(0));
+    //o ficheiro binario e escrito antes, cada fill so o le
+    Graph converted;
+    converted.setDatasetDirectory(directory);
+    converted.readStations();
+    converted.readNetwork();
+    converted.saveBinaryDataset();
+    for (auto _ : state) {
+        Graph graph;
+        graph.setDatasetDirectory(directory);
+        graph.fill();
+        if (graph.getStationSet().empty()) {
+            state.SkipWithError("the dataset could not be read");
+            break;
+        }
+        benchmark::DoNotOptimize(graph.getStationSet().data());
+    }
+    reportPeakMemory(state);
+}
+BENCHMARK(BM_Fill)->Arg(0)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+static void BM_AddRemoveStation(benchmark::State& state) {
+    Network* network = networkOf(state);
+    if (network == nullptr) return;
+    Graph& graph = *network->graph;
+    const std::string& neighbour = network->pairs[0].first;
+    for (auto _ : state) {
+        graph.addStation("benchmark", "benchmark", "benchmark", "benchmark", "benchmark");
+        graph.addBidirectionalLine("benchmark", neighbour, 1, SERVICE_STANDARD);
+        benchmark::DoNotOptimize(graph.removeStation(graph.findStation("benchmark")));
+    }
+    reportPeakMemory(state);
+}
+BENCHMARK(BM_AddRemoveStation)->Arg(0)->Arg(1000)->Arg(10000)->Arg(100000);
+
+static void BM_Snapshot(benchmark::State& state) {
+    Network* network = networkOf(state);
+    if (network == nullptr) return;
+    Graph& graph = *network->graph;
+    for (auto _ : state) {
+        invalidate(state, graph);
+        benchmark::DoNotOptimize(graph.getSnapshot().getNumStations());
+    }
+    reportPeakMemory(state);
+}
+BENCHMARK(BM_Snapshot)->Arg(0)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+static void BM_Dfs(benchmark::State& state) {
+    Network* network = networkOf(state);
+    if (network == nullptr) return;
+    Graph& graph = *network->graph;
+    std::size_t i = 0;
+    for (auto _ : state) {
+        auto& pair = network->pairs[i++ % network->pairs.size()];
+        benchmark::DoNotOptimize(graph.dfs(pair.first, pair.second, SERVICE_ALL));
+    }
+    reportPeakMemory(state);
+}
+BENCHMARK(BM_Dfs)->Arg(0)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+static void BM_MaxFlow(benchmark::State& state) {
+    Network* network = networkOf(state);
+    if (network == nullptr) return;
+    Graph& graph = *network->graph;
+    std::size_t i = 0;
+    for (auto _ : state) {
+        auto& pair = network->pairs[i++ % network->pairs.size()];
+        benchmark::DoNotOptimize(graph.maxFlow(pair.first, pair.second));
+    }
+    reportPeakMemory(state);
+}
+BENCHMARK(BM_MaxFlow)->Arg(0)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+static void BM_MaxFlowCached(benchmark::State& state) {
+    Network* network = networkOf(state);
+    if (network == nullptr) return;
+    Graph& graph = *network->graph;
+    graph.setCacheCapacity(DEFAULT_CACHE_CAPACITY);
+    std::size_t i = 0;
+    for (auto _ : state) {
+        auto& pair = network->pairs[i++ % network->pairs.size()];
+        benchmark::DoNotOptimize(graph.maxFlow(pair.first, pair.second));
+    }
+    graph.setCacheCapacity(0);
+    state.counters["hit_rate"] = graph.getCacheStats().hitRate();
+    reportPeakMemory(state);
+}
+BENCHMARK(BM_MaxFlowCached)->Arg(0)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+static void BM_MaxFlows(benchmark::State& state) {
+    Network* network = networkOf(state);
+    if (network == nullptr) return;
+    Graph& graph = *network->graph;
+    std::vector<std::pair<Station*, Station*>> pairs;
+    for (auto& pair : network->pairs) {
+        pairs.emplace_back(graph.findStation(pair.first), graph.findStation(pair.second));
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(graph.maxFlows(pairs).data());
+    }
+    state.SetItemsProcessed((int64_t) state.iterations() * (int64_t) pairs.size());
+    reportPeakMemory(state);
+}
+BENCHMARK(BM_MaxFlows)->Arg(0)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_GomoryHuTree(benchmark::State& state) {
+    Network* network = networkOf(state);
+    if (network == nullptr) return;
+    Graph& graph = *network->graph;
+    for (auto _ : state) {
+        invalidate(state, graph);
+        benchmark::DoNotOptimize(graph.getGomoryHuTree());
+    }
+    reportPeakMemory(state);
+}
+BENCHMARK(BM_GomoryHuTree)->Arg(0)->Arg(1000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_FullMaxFlow(benchmark::State& state) {
+    Network* network = networkOf(state);
+    if (network == nullptr) return;
+    Graph& graph = *network->graph;
+    for (auto _ : state) {
+        invalidate(state, graph);
+        benchmark::DoNotOptimize(graph.fullMaxFlow().data());
+    }
+    reportPeakMemory(state);
+}
+BENCHMARK(BM_FullMaxFlow)->Arg(0)->Arg(1000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+//com a arvore de Gomory-Hu ja construida (medida em BM_GomoryHuTree)
+static void BM_TopDistricts(benchmark::State& state) {
+    Network* network = networkOf(state);
+    if (network == nullptr) return;
+    Graph& graph = *network->graph;
+    graph.getGomoryHuTree();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(graph.topDistricts(10).data());
+    }
+    reportPeakMemory(state);
+}
+BENCHMARK(BM_TopDistricts)->Arg(0)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+static void BM_TopMunicipalities(benchmark::State& state) {
+    Network* network = networkOf(state);
+    if (network == nullptr) return;
+    Graph& graph = *network->graph;
+    graph.getGomoryHuTree();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(graph.topMunicipalities(10).data());
+    }
+    reportPeakMemory(state);
+}
+BENCHMARK(BM_TopMunicipalities)->Arg(0)->Arg(1000)->Unit(benchmark::kMicrosecond);
+
+static void BM_TopDistrictsInduced(benchmark::State& state) {
+    Network* network = networkOf(state);
+    if (network == nullptr) return;
+    Graph& graph = *network->graph;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(graph.topRegions(&Station::getDistrictId, 10, true).data());
+    }
+    reportPeakMemory(state);
+}
+BENCHMARK(BM_TopDistrictsInduced)->Arg(0)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+static void BM_MaxFlowGridToStation(benchmark::State& state) {
+    Network* network = networkOf(state);
+    if (network == nullptr) return;
+    Graph& graph = *network->graph;
+    std::size_t i = 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(graph.maxFlowGridToStation(network->pairs[i++ % network->pairs.size()].second));
+    }
+    reportPeakMemory(state);
+}
+BENCHMARK(BM_MaxFlowGridToStation)->Arg(0)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+//no dataset e usado o indice de rotas, nas redes sinteticas e usado o PathEngine
+static void BM_MaxFlowMinCost(benchmark::State& state) {
+    Network* network = networkOf(state);
+    if (network == nullptr) return;
+    Graph& graph = *network->graph;
+    if (state.range(0) == 0) graph.buildRouteIndex();
+    std::string service;
+    std::size_t i = 0;
+    for (auto _ : state) {
+        auto& pair = network->pairs[i++ % network->pairs.size()];
+        benchmark::DoNotOptimize(graph.maxFlowMinCost(pair.first, pair.second, service));
+    }
+    reportPeakMemory(state);
+}
+BENCHMARK(BM_MaxFlowMinCost)->Arg(0)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+static void BM_MaxFlowSubGraph(benchmark::State& state) {
+    Network* network = networkOf(state);
+    if (network == nullptr) return;
+    Graph& graph = *network->graph;
+    auto& pair = network->pairs[0];
+    std::size_t i = 0;
+    for (auto _ : state) {
+        std::vector<std::pair<std::string, std::string>> linesToRemove = {network->lines[i++ % network->lines.size()]};
+        benchmark::DoNotOptimize(graph.maxFlowSubGraph(linesToRemove, pair.first, pair.second));
+    }
+    reportPeakMemory(state);
+}
+BENCHMARK(BM_MaxFlowSubGraph)->Arg(0)->Arg(1000)->Arg(10000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+static void BM_TopStationsAffected(benchmark::State& state) {
+    Network* network = networkOf(state);
+    if (network == nullptr) return;
+    Graph& graph = *network->graph;
+    std::size_t i = 0;
+    bool error = false;
+    for (auto _ : state) {
+        std::vector<std::pair<std::string, std::string>> linesToRemove = {network->lines[i++ % network->lines.size()]};
+        benchmark::DoNotOptimize(graph.topStationsAffected(linesToRemove, 10, error).data());
+    }
+    reportPeakMemory(state);
+}
+BENCHMARK(BM_TopStationsAffected)->Arg(0)->Arg(1000)->Unit(benchmark::kMillisecond)->UseRealTime();
+
+//com a arvore de Gomory-Hu ja construida, as alocacoes contadas sao so as do proprio fullMaxFlow (pares, nomes, ...)
+static void BM_FullMaxFlowAllocations(benchmark::State& state) {
+    Network* network = networkOf(state);
+    if (network == nullptr) return;
+    Graph& graph = *network->graph;
+    graph.getGomoryHuTree();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(graph.fullMaxFlow().data());
+    }
+    reportPeakMemory(state);
+}
+BENCHMARK(BM_FullMaxFlowAllocations)->Arg(0)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+//sempre a mesma linha removida, para as alocacoes de cada iteracao serem iguais
+static void BM_TopStationsAffectedAllocations(benchmark::State& state) {
+    Network* network = networkOf(state);
+    if (network == nullptr) return;
+    Graph& graph = *network->graph;
+    std::vector<std::pair<std::string, std::string>> linesToRemove = {network->lines[0]};
+    bool error = false;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(graph.topStationsAffected(linesToRemove, 10, error).data());
+    }
+    reportPeakMemory(state);
+}
+BENCHMARK(BM_TopStationsAffectedAllocations)->Arg(0)->Arg(1000)->Unit(benchmark::kMillisecond);
+
+/**
+ * @brief Runs the benchmarks of the public methods of Graph, on the dataset (argument 0) and on synthetic networks with
+ * 1k, 10k and 100k stations (the argument is the number of stations, see NetworkGenerator).
+ *
+ * Run from the build directory, like the project, so the dataset is found. The files written by the benchmarks are
+ * kept in a directory of the temporary directory of the system (see fixtureDirectory), removed at the end. Besides the
+ * time, each benchmark reports the allocations of one iteration (allocs_per_iter and max_bytes_used) and the peak
+ * resident set size of the process (peak_rss_mb). The results can be saved to compare builds:
+ *
+ *     ./benchmarks --benchmark_out=results.json --benchmark_out_format=json
+ *
+ * The result caches are disabled (except in BM_MaxFlowCached), so every call runs its algorithm.
+ */
+int main(int argc, char** argv) {
+    AllocationCounter allocationCounter;
+    benchmark::RegisterMemoryManager(&allocationCounter);
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) return 1;
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    benchmark::RegisterMemoryManager(nullptr);
+
+    std::error_code error;
+    std::filesystem::remove_all(fixtureDirectory(), error);
+    return 0;
+}
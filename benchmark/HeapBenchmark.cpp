@@ -0,0 +1,203 @@
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <limits>
+#include <string>
+
+#include "../include/MutablePriorityQueue.h"
+#include "../include/DaryHeap.h"
+
+/**
+ * @brief A node of MutablePriorityQueue.
+ */
+struct QueueNode {
+    int id;
+    double key;
+    int queueIndex;
+    bool operator<(QueueNode& node) const { return key < node.key; }
+};
+
+/**
+ * @brief A synthetic network in CSR form: a square grid with random capacities, like a mesh of rail lines.
+ */
+struct Network {
+    std::vector<int> offsets;
+    std::vector<int> targets;
+    std::vector<double> costs;
+};
+
+/**
+ * @brief Builds a square grid with random integer costs.
+ *
+ * @param side The number of stations in each row and column.
+ * @param seed The seed of the costs.
+ * @return The network.
+ */
+static Network makeGrid(int side, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> cost(1, 100);
+    int n = side * side;
+    Network network;
+    network.offsets.assign(n + 1, 0);
+    for (int v = 0; v < n; v++) {
+        int row = v / side, column = v % side;
+        if (row > 0) network.targets.push_back(v - side);
+        if (row + 1 < side) network.targets.push_back(v + side);
+        if (column > 0) network.targets.push_back(v - 1);
+        if (column + 1 < side) network.targets.push_back(v + 1);
+        network.offsets[v + 1] = (int) network.targets.size();
+    }
+    for (std::size_t e = 0; e < network.targets.size(); e++) {
+        network.costs.push_back(cost(rng));
+    }
+    return network;
+}
+
+/**
+ * @brief Runs Dijkstra with MutablePriorityQueue, inserting the stations when they are reached.
+ *
+ * @return The sum of the distances, so the search is not optimized away.
+ */
+static double dijkstraBinary(const Network& network, int s) {
+    int n = (int) network.offsets.size() - 1;
+    std::vector<QueueNode> nodes(n);
+    std::vector<double> distance(n, std::numeric_limits<double>::infinity());
+    MutablePriorityQueue<QueueNode> q;
+    distance[s] = 0;
+    nodes[s] = {s, 0, 0};
+    q.insert(&nodes[s]);
+    double total = 0;
+    while (!q.empty()) {
+        int u = q.extractMin()->id;
+        total += distance[u];
+        for (int e = network.offsets[u]; e < network.offsets[u + 1]; e++) {
+            int w = network.targets[e];
+            double cost = distance[u] + network.costs[e];
+            if (cost >= distance[w]) continue;
+            bool inQueue = distance[w] != std::numeric_limits<double>::infinity();
+            distance[w] = cost;
+            nodes[w] = {w, cost, nodes[w].queueIndex};
+            if (inQueue) q.decreaseKey(&nodes[w]);
+            else q.insert(&nodes[w]);
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief Runs Dijkstra with a DaryHeap, inserting the stations when they are reached.
+ *
+ * @return The sum of the distances, so the search is not optimized away.
+ */
+template <int D>
+static double dijkstraDary(const Network& network, int s) {
+    int n = (int) network.offsets.size() - 1;
+    std::vector<double> distance(n, std::numeric_limits<double>::infinity());
+    DaryHeap<double, D> q(n);
+    distance[s] = 0;
+    q.insert(s, 0);
+    double total = 0;
+    while (!q.empty()) {
+        int u = q.extractMin();
+        total += distance[u];
+        for (int e = network.offsets[u]; e < network.offsets[u + 1]; e++) {
+            int w = network.targets[e];
+            double cost = distance[u] + network.costs[e];
+            if (cost >= distance[w]) continue;
+            bool inQueue = distance[w] != std::numeric_limits<double>::infinity();
+            distance[w] = cost;
+            if (inQueue) q.decreaseKey(w, cost);
+            else q.insert(w, cost);
+        }
+    }
+    return total;
+}
+
+/**
+ * @brief Fills a MutablePriorityQueue one element at a time and empties it.
+ *
+ * @return The sum of the ids, so the work is not optimized away.
+ */
+static double fillBinary(const std::vector<double>& keys) {
+    int n = (int) keys.size();
+    std::vector<QueueNode> nodes(n);
+    MutablePriorityQueue<QueueNode> q;
+    for (int i = 0; i < n; i++) {
+        nodes[i] = {i, keys[i], 0};
+        q.insert(&nodes[i]);
+    }
+    double total = 0;
+    while (!q.empty()) total += q.extractMin()->id;
+    return total;
+}
+
+/**
+ * @brief Builds a DaryHeap with heapify (or with one insertion per element) and empties it.
+ *
+ * @return The sum of the ids, so the work is not optimized away.
+ */
+template <int D>
+static double fillDary(const std::vector<double>& keys, bool bulk) {
+    int n = (int) keys.size();
+    DaryHeap<double, D> q(n);
+    if (bulk) {
+        std::vector<std::pair<double, int>> items(n);
+        for (int i = 0; i < n; i++) items[i] = {keys[i], i};
+        q.heapify(items);
+    }
+    else {
+        for (int i = 0; i < n; i++) q.insert(i, keys[i]);
+    }
+    double total = 0;
+    while (!q.empty()) total += q.extractMin();
+    return total;
+}
+
+/**
+ * @brief Runs a function a few times and prints the best time.
+ */
+template <class F>
+static void measure(const std::string& name, int repetitions, F f) {
+    double best = std::numeric_limits<double>::infinity(), result = 0;
+    for (int r = 0; r < repetitions; r++) {
+        auto start = std::chrono::steady_clock::now();
+        result = f();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed.count() < best) best = elapsed.count();
+    }
+    std::cout << std::left << std::setw(36) << name << std::right << std::setw(10) << std::fixed << std::setprecision(2)
+              << best << " ms   (" << std::setprecision(0) << result << ")\n";
+}
+
+/**
+ * @brief Compares MutablePriorityQueue with 2-, 4- and 8-ary DaryHeap on Dijkstra over a grid and on filling and emptying.
+ *
+ * Usage: heap_benchmark [side of the grid] [number of keys]
+ */
+int main(int argc, char** argv) {
+    int side = argc > 1 ? std::stoi(argv[1]) : 500;
+    int size = argc > 2 ? std::stoi(argv[2]) : 1000000;
+    const int repetitions = 5;
+
+    Network network = makeGrid(side, 42);
+    int source = (side / 2) * side + side / 2;
+    std::cout << "dijkstra on a " << side << "x" << side << " grid\n";
+    measure("MutablePriorityQueue", repetitions, [&] { return dijkstraBinary(network, source); });
+    measure("DaryHeap<2>", repetitions, [&] { return dijkstraDary<2>(network, source); });
+    measure("DaryHeap<4>", repetitions, [&] { return dijkstraDary<4>(network, source); });
+    measure("DaryHeap<8>", repetitions, [&] { return dijkstraDary<8>(network, source); });
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<double> key(0, 1e6);
+    std::vector<double> keys(size);
+    for (double& k : keys) k = key(rng);
+    std::cout << "\nfill and empty " << size << " keys\n";
+    measure("MutablePriorityQueue (insert)", repetitions, [&] { return fillBinary(keys); });
+    measure("DaryHeap<4> (insert)", repetitions, [&] { return fillDary<4>(keys, false); });
+    measure("DaryHeap<4> (heapify)", repetitions, [&] { return fillDary<4>(keys, true); });
+    measure("DaryHeap<8> (insert)", repetitions, [&] { return fillDary<8>(keys, false); });
+    measure("DaryHeap<8> (heapify)", repetitions, [&] { return fillDary<8>(keys, true); });
+    return 0;
+}
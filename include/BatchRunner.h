@@ -0,0 +1,191 @@
+#ifndef DA_PROJ1_BATCHRUNNER_H
+#define DA_PROJ1_BATCHRUNNER_H
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+
+#include "Graph.h"
+
+class BatchRunner;
+
+/**
+ * @brief The formats of the results of a batch.
+ */
+enum BatchFormat {
+    FORMAT_JSON_LINES,
+    FORMAT_CSV
+};
+
+/**
+ * @brief Gets the format with a given name ("jsonl" or "csv").
+ *
+ * @note Complexity time: O(1).
+ *
+ * @param name The name of the format.
+ * @param format The format. Initialized only if the name is valid.
+ * @return True if the name is valid.
+ * @return False otherwise.
+ */
+bool parseBatchFormat(const std::string& name, BatchFormat& format);
+
+/**
+ * @brief Answers a file of queries without the menu, writing one result per query in a machine-readable format.
+ *
+ * The queries are rows of a CSV file (quoted station names may have commas), one per row:
+ * - maxflow,origin,destination
+ * - mincost,origin,destination
+ * - grid-to-station,station
+ * - what-if,origin,destination,station A,station B,... (the max flow without the lines between each pair of stations)
+ *
+ * The graph is loaded once and each row is answered as soon as it is read (only a run of consecutive queries computed
+ * together in parallel is kept). The results are written in the order of the queries, and they are kept in a buffer
+ * that is written to the output when it is full or when the input has no more rows ready (e.g. a pipe waiting for its
+ * writer). So a file is never flushed per result, and a pipeline gets its answers without waiting for the end of the input.
+ */
+class BatchRunner {
+    /**
+     * @brief A query of the batch.
+     */
+    struct Query {
+        /**
+         * @brief The line of the query in the input.
+         */
+        int line;
+        std::string command;
+        std::vector<std::string> args;
+    };
+
+    /**
+     * @brief A result of the batch. Only the fields of the query are written.
+     */
+    struct Result {
+        double flow = -1;
+        double cost = -1;
+        std::string service;
+        /**
+         * @brief The description of the problem, empty if the query was answered.
+         */
+        std::string error;
+    };
+
+    /**
+     * @brief The size of the output buffer that triggers a write.
+     */
+    static const std::size_t BUFFER_SIZE = 1 << 16;
+
+    /**
+     * @brief The most consecutive queries computed together in parallel.
+     */
+    static const std::size_t MAX_GROUP_SIZE = 1024;
+
+    /**
+     * @brief The graph, loaded once.
+     */
+    Graph& graph;
+
+    /**
+     * @brief The state of the queries of the runner, so many runners can answer queries on the same graph at the same
+     * time (see QueryServer).
+     */
+    QueryContext context;
+
+    /**
+     * @brief The format of the results.
+     */
+    BatchFormat format;
+
+    /**
+     * @brief If true, consecutive maxflow and grid-to-station queries are computed together by the workers of the graph.
+     */
+    bool parallel;
+
+    /**
+     * @brief The results that were not written yet.
+     */
+    std::string buffer;
+
+    /**
+     * @brief Computes one query on the calling thread.
+     *
+     * @param query The query.
+     * @return The result.
+     */
+    Result execute(const Query& query);
+
+    /**
+     * @brief Computes consecutive queries of the same command (maxflow or grid-to-station) in parallel.
+     *
+     * @param queries The queries.
+     * @param results The result of each query, in the same order. Must be initialized in this function.
+     */
+    void executeGroup(const std::vector<const Query*>& queries, std::vector<Result>& results);
+
+    /**
+     * @brief Computes a group of queries (see executeGroup), appends their results and empties the group.
+     *
+     * @param group The queries.
+     * @param out The output.
+     */
+    void runGroup(std::vector<Query>& group, std::ostream& out);
+
+    /**
+     * @brief Appends a result to the buffer, in the format of the runner.
+     *
+     * @param query The query.
+     * @param result The result.
+     */
+    void append(const Query& query, const Result& result);
+
+    /**
+     * @brief Writes the buffer to the output when it is full.
+     *
+     * @param out The output.
+     */
+    void flushIfFull(std::ostream& out);
+
+    /**
+     * @brief Writes the buffer to the output and flushes the output.
+     *
+     * @param out The output.
+     */
+    void flush(std::ostream& out);
+
+public:
+    /**
+     * @brief Creates a runner for a loaded graph.
+     *
+     * @param graph The graph. Must outlive the runner.
+     * @param format The format of the results.
+     * @param parallel If true, consecutive maxflow and grid-to-station queries are computed in parallel.
+     */
+    BatchRunner(Graph& graph, BatchFormat format, bool parallel);
+
+    /**
+     * @brief Answers every query of the input.
+     *
+     * @note The rows that are not a known query are answered with an error, so each query has exactly one result.
+     * @note Complexity time: the sum of the complexities of the queries.
+     *
+     * @param in The queries.
+     * @param name The name of the input, used in the error messages.
+     * @param out The output of the results.
+     * @return True if the input could be read.
+     * @return False otherwise.
+     */
+    bool run(std::istream& in, const std::string& name, std::ostream& out);
+
+    /**
+     * @brief Answers a single query, given as one CSV row (see QueryServer).
+     *
+     * @note Complexity time: the complexity of the query.
+     *
+     * @param row The query.
+     * @param line The number written as the line of the query.
+     * @return The result in the format of the runner, without the line break (and without the CSV header).
+     */
+    std::string answer(const std::string& row, int line);
+};
+
+#endif //DA_PROJ1_BATCHRUNNER_H
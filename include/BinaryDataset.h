@@ -0,0 +1,73 @@
+#ifndef DA_PROJ1_BINARYDATASET_H
+#define DA_PROJ1_BINARYDATASET_H
+
+#include <string>
+#include <cstdint>
+
+class Graph;
+
+/**
+ * @brief The version of the binary dataset format. Files with another version are ignored.
+ */
+const std::uint32_t BINARY_DATASET_VERSION = 1;
+
+/**
+ * @brief Identifies the CSV files a binary dataset was converted from, so stale binary datasets are detected.
+ */
+struct DatasetFingerprint {
+    std::uint64_t stationsSize = 0;
+    std::uint64_t stationsTime = 0;
+    std::uint64_t networkSize = 0;
+    std::uint64_t networkTime = 0;
+
+    bool operator==(const DatasetFingerprint& other) const {
+        return stationsSize == other.stationsSize && stationsTime == other.stationsTime &&
+               networkSize == other.networkSize && networkTime == other.networkTime;
+    }
+};
+
+/**
+ * @brief Gets the size and modification time of the CSV files of a dataset (zero for the files that do not exist).
+ *
+ * @note Complexity time: O(1).
+ *
+ * @param stationsPath The path of the stations file.
+ * @param networkPath The path of the network file.
+ * @return The fingerprint of the dataset.
+ */
+DatasetFingerprint fingerprintDataset(const std::string& stationsPath, const std::string& networkPath);
+
+/**
+ * @brief Writes the stations and lines of a graph in the binary dataset format.
+ *
+ * The file has a header (magic, version, the fingerprint of the source CSV files and a FNV-1a checksum of the rest
+ * of the file), a string table with every distinct name, one record per station with the indexes of its strings and
+ * the lines in CSR form (offsets, destination, reverse, capacity and service), in the same order as the graph.
+ *
+ * @note Numbers the stations and lines by their position in the graph (Station::setId and Edge::setId).
+ * @note Complexity time: O(V + E).
+ *
+ * @param graph The graph.
+ * @param path The path of the binary file.
+ * @param source The fingerprint of the CSV files the graph was read from.
+ * @return True if the file was written.
+ * @return False otherwise.
+ */
+bool writeBinaryDataset(const Graph& graph, const std::string& path, const DatasetFingerprint& source);
+
+/**
+ * @brief Adds the stations and lines of a binary dataset to an empty graph.
+ *
+ * @note The whole file is read with a single read and validated before the graph is changed. The stations and lines
+ * are then added one at a time, like readStations and readNetwork do, without parsing any text.
+ * @note Complexity time: O(V + E).
+ *
+ * @param graph The graph. Must be empty.
+ * @param path The path of the binary file.
+ * @param source The fingerprint of the current CSV files.
+ * @return True if the file was loaded.
+ * @return False if it does not exist, is corrupted, has another version or was converted from other CSV files.
+ */
+bool readBinaryDataset(Graph& graph, const std::string& path, const DatasetFingerprint& source);
+
+#endif //DA_PROJ1_BINARYDATASET_H
@@ -0,0 +1,111 @@
+#ifndef DA_PROJ1_BINARYIO_H
+#define DA_PROJ1_BINARYIO_H
+
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cstdint>
+#include <fstream>
+
+/**
+ * @brief The initial value of a FNV-1a hash.
+ */
+const std::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+
+/**
+ * @brief Calculates the FNV-1a hash of a block of bytes, continuing a previous hash.
+ *
+ * @note Complexity time: O(n).
+ *
+ * @param data The bytes.
+ * @param size The number of bytes.
+ * @param hash The hash of the previous blocks (FNV_OFFSET_BASIS for the first one).
+ * @return The hash.
+ */
+inline std::uint64_t fnv1a(const void* data, std::size_t size, std::uint64_t hash = FNV_OFFSET_BASIS) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Appends the bytes of a value to a buffer.
+ */
+template <typename T>
+void put(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * @brief Appends the bytes of every value of a vector to a buffer.
+ */
+template <typename T>
+void putArray(std::string& out, const std::vector<T>& values) {
+    if (!values.empty()) out.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+}
+
+/**
+ * @brief Reads values from a block of bytes, failing instead of reading past its end.
+ */
+struct BinaryReader {
+    const char* data;
+    std::size_t size;
+    std::size_t position = 0;
+
+    template <typename T>
+    bool get(T& value) {
+        if (size - position < sizeof(T)) return false;
+        std::memcpy(&value, data + position, sizeof(T));
+        position += sizeof(T);
+        return true;
+    }
+
+    template <typename T>
+    bool getArray(std::vector<T>& values, std::size_t n) {
+        if ((size - position) / sizeof(T) < n) return false;
+        values.resize(n);
+        if (n > 0) std::memcpy(values.data(), data + position, n * sizeof(T));
+        position += n * sizeof(T);
+        return true;
+    }
+};
+
+/**
+ * @brief Reads a whole file with a single read.
+ *
+ * @note Complexity time: O(n), n being the size of the file.
+ *
+ * @param path The path of the file.
+ * @param contents The bytes of the file. Must be initialized in this function.
+ * @return True if the file was read and is not empty.
+ * @return False otherwise.
+ */
+inline bool readWholeFile(const std::string& path, std::vector<char>& contents) {
+    std::ifstream file(path, std::ios::binary);
+    if (file.fail()) return false;
+    file.seekg(0, std::ios::end);
+    std::streamoff size = file.tellg();
+    if (size <= 0) return false;
+    file.seekg(0, std::ios::beg);
+    contents.resize((std::size_t) size);
+    file.read(contents.data(), size);
+    return file.gcount() == size;
+}
+
+/**
+ * @brief Writes a file through a temporary file, so an incomplete file never replaces the previous one.
+ *
+ * @note Complexity time: O(n), n being the size of the file.
+ *
+ * @param path The path of the file.
+ * @param header The first bytes of the file.
+ * @param payload The rest of the file.
+ * @return True if the file was written.
+ * @return False otherwise.
+ */
+bool writeFileAtomically(const std::string& path, const std::string& header, const std::string& payload);
+
+#endif //DA_PROJ1_BINARYIO_H
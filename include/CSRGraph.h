@@ -0,0 +1,231 @@
+#ifndef DA_PROJ1_CSRGRAPH_H
+#define DA_PROJ1_CSRGRAPH_H
+
+#include <vector>
+#include <cstdint>
+
+#include "StationEdge.h"
+
+class CSRGraph;
+
+/**
+ * @brief A read-only compressed sparse row (CSR) snapshot of a railway network.
+ *
+ * Stations are identified by their id (their position in the graph's station set when the snapshot was taken) and
+ * the lines that leave station v are stored contiguously between offsets[v] and offsets[v + 1].
+ * Every line has a reverse line. Lines that were added with addBidirectionalLine use each other as reverse, the
+ * others get an extra residual line with no capacity and no service, which is only used by the max flow engines.
+ * The snapshot holds no flow: every MaxFlowEngine keeps its own flow for each line.
+ */
+class CSRGraph {
+    /**
+     * @brief The position of the first outgoing line of each station. Has one more element than the number of stations.
+     */
+    std::vector<int> offsets;
+
+    /**
+     * @brief The station where each line ends.
+     */
+    std::vector<int> targets;
+
+    /**
+     * @brief The index of the reverse of each line.
+     */
+    std::vector<int> reverse;
+
+    /**
+     * @brief The maximum number of trains that can simultaneously travel in each line.
+     */
+    std::vector<double> capacity;
+
+    /**
+     * @brief The service of each line.
+     */
+    std::vector<ServiceMask> service;
+
+public:
+    /**
+     * @brief Creates an empty snapshot.
+     */
+    CSRGraph(){};
+
+    /**
+     * @brief Creates a snapshot of the given stations and of the lines that leave them.
+     *
+     * @note The id of every station is set to its position in the vector, and the id of every line to its position among the lines that leave the stations.
+     * @note Complexity time: O(V + E).
+     *
+     * @param stations The stations of the graph.
+     */
+    explicit CSRGraph(const std::vector<Station*>& stations);
+
+    /**
+     * @brief Creates a copy of a snapshot with an extra station (a super source) connected in both directions to the given stations.
+     *
+     * @note The super source gets the id graph.getNumStations(). Its lines are placed after the other lines of each station.
+     * @note Complexity time: O(V + E).
+     *
+     * @param graph The snapshot to be copied.
+     * @param sources The ids of the stations connected to the super source.
+     * @param capacity The capacity of the lines of the super source.
+     * @param service The service of the lines of the super source.
+     */
+    CSRGraph(const CSRGraph& graph, const std::vector<int>& sources, double capacity, ServiceMask service);
+
+    /**
+     * @brief Creates the subgraph of a snapshot induced by some of its stations (the stations and the lines between them).
+     *
+     * @note The station stations[i] gets the id i. The lines keep their order.
+     * @note Complexity time: O(V + E) of the stations in the subgraph and O(V) to map the ids.
+     *
+     * @param graph The snapshot.
+     * @param stations The ids of the stations in the snapshot, without repetitions.
+     */
+    CSRGraph(const CSRGraph& graph, const std::vector<int>& stations);
+
+    /**
+     * @brief Gets the number of stations in the snapshot.
+     *
+     * @note Complexity time: O(1).
+     *
+     * @return The number of stations.
+     */
+    int getNumStations() const;
+
+    /**
+     * @brief Gets the number of lines in the snapshot, including the residual lines.
+     *
+     * @note Complexity time: O(1).
+     *
+     * @return The number of lines.
+     */
+    int getNumLines() const;
+
+    /**
+     * @brief Gets the position of the first outgoing line of a station.
+     *
+     * @note Complexity time: O(1).
+     *
+     * @param v The id of the station.
+     * @return The index of the line.
+     */
+    int begin(int v) const { return offsets[v]; }
+
+    /**
+     * @brief Gets the position after the last outgoing line of a station.
+     *
+     * @note Complexity time: O(1).
+     *
+     * @param v The id of the station.
+     * @return The index of the line.
+     */
+    int end(int v) const { return offsets[v + 1]; }
+
+    /**
+     * @brief Gets the station where a line ends.
+     *
+     * @note Complexity time: O(1).
+     *
+     * @param e The index of the line.
+     * @return The id of the station.
+     */
+    int getTarget(int e) const { return targets[e]; }
+
+    /**
+     * @brief Gets the reverse of a line.
+     *
+     * @note Complexity time: O(1).
+     *
+     * @param e The index of the line.
+     * @return The index of the reverse line.
+     */
+    int getReverse(int e) const { return reverse[e]; }
+
+    /**
+     * @brief Gets the maximum number of trains that can simultaneously travel in a line.
+     *
+     * @note Complexity time: O(1).
+     *
+     * @param e The index of the line.
+     * @return The capacity.
+     */
+    double getCapacity(int e) const { return capacity[e]; }
+
+    /**
+     * @brief Gets the service of a line.
+     *
+     * @note Complexity time: O(1).
+     *
+     * @param e The index of the line.
+     * @return The service. SERVICE_NONE for residual lines.
+     */
+    ServiceMask getService(int e) const { return service[e]; }
+
+    /**
+     * @brief Sees if every line has a reverse line with the same capacity, which is the case when all the lines were added with addBidirectionalLine.
+     *
+     * @note Complexity time: O(E).
+     *
+     * @return True if the network is undirected.
+     * @return False otherwise.
+     */
+    bool isUndirected() const;
+
+    /**
+     * @brief Sees if the capacity of every line with a service is a non-negative integer and the sum of all of them is
+     * exactly representable, so every path cost is an integer and the searches can use a RadixHeap.
+     *
+     * @note Complexity time: O(E).
+     *
+     * @return True if the costs are integers.
+     * @return False otherwise.
+     */
+    bool hasIntegerCapacities() const;
+
+    /**
+     * @brief Finds the connected components of the network, considering every line as undirected.
+     *
+     * @note Complexity time: O(V+E).
+     *
+     * @param component The component of each station. Must be initialized in this function.
+     */
+    void connectedComponents(std::vector<int>& component) const;
+
+    /**
+     * @brief Sees if there is a path between two stations using only the lines of the given services (DFS).
+     *
+     * @note Complexity time: O(V+E)
+     *
+     * @param s The id of the origin station.
+     * @param t The id of the destination station.
+     * @param services The services that the path can use.
+     * @return True if a path exists.
+     * @return False otherwise.
+     */
+    bool dfs(int s, int t, ServiceMask services) const;
+
+    /**
+     * @brief Sees if there is a path between any of the given stations and another station using only the lines of the given services (DFS).
+     *
+     * @note The destination station is ignored if it is one of the origin stations.
+     * @note Complexity time: O(V+E)
+     *
+     * @param sources The ids of the origin stations.
+     * @param t The id of the destination station.
+     * @param services The services that the path can use.
+     * @return True if a path exists.
+     * @return False otherwise.
+     */
+    bool dfs(const std::vector<int>& sources, int t, ServiceMask services) const;
+
+    /**
+     * @brief Calculates a hash of the whole snapshot (stations, lines, capacities and services), to detect files computed from another network.
+     *
+     * @note Complexity time: O(V + E).
+     *
+     * @return The hash.
+     */
+    std::uint64_t checksum() const;
+};
+
+#endif //DA_PROJ1_CSRGRAPH_H
@@ -0,0 +1,148 @@
+#ifndef DA_PROJ1_CSVREADER_H
+#define DA_PROJ1_CSVREADER_H
+
+#include <vector>
+#include <string>
+#include <string_view>
+#include <istream>
+
+class CSVReader;
+
+/**
+ * @brief Parses a number with std::from_chars, ignoring surrounding spaces.
+ *
+ * @note Complexity time: O(n), n being the length of the field.
+ *
+ * @param field The text of the field.
+ * @param value The number. Initialized only if the field is valid.
+ * @return True if the whole field is a number.
+ * @return False otherwise.
+ */
+bool parseDouble(std::string_view field, double& value);
+
+/**
+ * @brief Reads the rows of a CSV file.
+ *
+ * The whole file is read into memory with a single read and the fields are returned as views into that buffer, so no
+ * string is allocated per field. A stream is read one row at a time instead, so its rows can be used as they arrive. Quoted fields (with commas, line breaks and "" escapes), CRLF line endings and a
+ * UTF-8 byte order mark are supported. Malformed rows are reported with their line number and skipped.
+ */
+class CSVReader {
+    /**
+     * @brief The path of the file, used in the error messages.
+     */
+    std::string path;
+
+    /**
+     * @brief The contents of the file. Quoted fields are unescaped in place.
+     */
+    std::string buffer;
+
+    /**
+     * @brief The position of the next character to be read.
+     */
+    std::size_t position = 0;
+
+    /**
+     * @brief The line where the last row starts.
+     */
+    int lineNumber = 0;
+
+    /**
+     * @brief The line of the next character to be read.
+     */
+    int nextLine = 1;
+
+    /**
+     * @brief True if the file was read.
+     */
+    bool open = false;
+
+    /**
+     * @brief The stream of the rows, null when reading a file.
+     */
+    std::istream* stream = nullptr;
+
+    /**
+     * @brief Reads a quoted field, unescaping it in place.
+     *
+     * @note Complexity time: O(n), n being the length of the field.
+     *
+     * @param fields The fields of the row, where the new field is added.
+     * @return True if the field is well formed.
+     * @return False otherwise.
+     */
+    bool readQuotedField(std::vector<std::string_view>& fields);
+
+    /**
+     * @brief Replaces the rows already read from the stream with the next row (and the empty lines before it), reading
+     * as many lines as its quoted fields span. Does nothing when reading a file.
+     *
+     * @note Complexity time: O(n), n being the length of the row.
+     */
+    void fill();
+
+    /**
+     * @brief Moves to the start of the next row.
+     *
+     * @note Complexity time: O(n), n being the length of the rest of the row.
+     */
+    void skipRow();
+
+public:
+    /**
+     * @brief Reads a CSV file.
+     *
+     * @note Complexity time: O(n), n being the size of the file.
+     *
+     * @param path The path of the file.
+     */
+    explicit CSVReader(const std::string& path);
+
+    /**
+     * @brief Reads CSV rows from a stream (e.g. the standard input) until it ends, one row at a time.
+     *
+     * @note The stream must outlive the reader.
+     * @note Complexity time: O(n), n being the length of the first row.
+     *
+     * @param in The stream.
+     * @param name The name of the stream, used in the error messages.
+     */
+    CSVReader(std::istream& in, const std::string& name);
+
+    /**
+     * @brief Sees if the file could be read.
+     *
+     * @return True if the file was read.
+     * @return False otherwise.
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Reads the next row, skipping empty lines and malformed rows.
+     *
+     * @note The fields are only valid while this reader exists (until the next call when reading a stream).
+     * @note Complexity time: O(n), n being the length of the row.
+     *
+     * @param fields The fields of the row. Must be initialized in this function.
+     * @return True if a row was read.
+     * @return False if there are no more rows.
+     */
+    bool readRow(std::vector<std::string_view>& fields);
+
+    /**
+     * @brief Gets the line where the last row starts.
+     *
+     * @return The line number, starting at 1.
+     */
+    int getLineNumber() const;
+
+    /**
+     * @brief Reports a problem in the last row to the standard error, as "path:line: message".
+     *
+     * @param message The description of the problem.
+     */
+    void reportError(const std::string& message) const;
+};
+
+#endif //DA_PROJ1_CSVREADER_H
@@ -0,0 +1,240 @@
+#ifndef DA_PROJ1_CONTRACTIONHIERARCHY_H
+#define DA_PROJ1_CONTRACTIONHIERARCHY_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+#include "CSRGraph.h"
+
+class ContractionHierarchy;
+
+/**
+ * @brief The version of the route index format. Files with another version are ignored.
+ */
+const std::uint32_t ROUTE_INDEX_VERSION = 1;
+
+/**
+ * @brief A contraction hierarchy of the lines of one service, answering minimal cost path queries on that service.
+ *
+ * The stations are contracted one at a time, from the least to the most important, and a shortcut replaces every
+ * minimal cost path that went through a contracted station. A query then only searches upwards (towards more important
+ * stations) from both ends, which visits a few hundred stations even in very large networks, and the shortcuts of the
+ * path found are unpacked back into lines of the snapshot.
+ *
+ * @note The cost of a line is its capacity, as in PathEngine.
+ */
+class ContractionHierarchy {
+    /**
+     * @brief A line of the hierarchy: a line of the snapshot or a shortcut made of two other arcs.
+     */
+    struct Arc {
+        int from;
+        int to;
+        double cost;
+        /**
+         * @brief The line of the snapshot, -1 for the shortcuts.
+         */
+        int line;
+        /**
+         * @brief The arcs that make the shortcut (from -> contracted station -> to).
+         */
+        int first;
+        int second;
+    };
+
+    /**
+     * @brief A node of the priority queues of the queries.
+     */
+    struct QueueNode {
+        int id;
+        double key;
+        int queueIndex;
+        bool operator<(QueueNode& node) const { return key < node.key; }
+    };
+
+public:
+    /**
+     * @brief The state of the queries of one thread: the searches from both ends, marked by query so they are not
+     * cleared between queries.
+     */
+    struct Search {
+        /**
+         * @brief The distance of each station in both searches.
+         */
+        std::vector<double> distance[2];
+
+        /**
+         * @brief The arc used to reach each station in both searches.
+         */
+        std::vector<int> parent[2];
+
+        /**
+         * @brief The query where each station was reached by both searches.
+         */
+        std::vector<unsigned> reached[2];
+
+        /**
+         * @brief The nodes of the priority queues of both searches.
+         */
+        std::vector<QueueNode> nodes[2];
+
+        /**
+         * @brief The current query.
+         */
+        unsigned stamp = 0;
+    };
+
+private:
+    /**
+     * @brief The service of the lines in the hierarchy.
+     */
+    ServiceMask service = SERVICE_NONE;
+
+    /**
+     * @brief The checksum of the snapshot the hierarchy was built from.
+     */
+    std::uint64_t source = 0;
+
+    /**
+     * @brief If every cost of the snapshot is an integer, so the queries can use a RadixHeap.
+     */
+    bool integerCosts = false;
+
+    /**
+     * @brief Every arc of the hierarchy.
+     */
+    std::vector<Arc> arcs;
+
+    /**
+     * @brief The position of the contraction of each station (higher is more important).
+     */
+    std::vector<int> rank;
+
+    /**
+     * @brief The position of the first upward arc of each station, for the search that leaves the origin station (the
+     * arcs that leave the station towards more important stations) and for the search that arrives at the destination
+     * station (the arcs that arrive at the station from more important stations).
+     */
+    std::vector<int> upOffsets[2];
+
+    /**
+     * @brief The upward arcs of every station, in the order of upOffsets.
+     */
+    std::vector<int> upArcs[2];
+
+    /**
+     * @brief Builds the upward arcs of each station from the arcs and the ranks.
+     *
+     * @note Complexity time: O(V + A), A being the number of arcs.
+     */
+    void buildUpwardGraph();
+
+    /**
+     * @brief Sizes the state of the queries for the stations of the hierarchy.
+     *
+     * @note Complexity time: O(V).
+     *
+     * @param search The state of the queries.
+     */
+    void prepare(Search& search) const;
+
+    /**
+     * @brief Appends the lines of the snapshot that an arc stands for, in order.
+     *
+     * @note Complexity time: O(k), k being the number of lines.
+     *
+     * @param arc The index of the arc.
+     * @param lines The lines of the path.
+     */
+    void unpack(int arc, std::vector<int>& lines) const;
+
+    /**
+     * @brief Runs the upward searches of shortestPath with the given priority queue, after the query was prepared.
+     *
+     * @note Complexity time: O(A' log V'), A' and V' being the arcs and stations above both ends in the hierarchy.
+     *
+     * @tparam Queue MutablePriorityQueue or, if the costs are integers, RadixHeap.
+     * @param s The id of the origin station.
+     * @param t The id of the destination station.
+     * @param lines The lines of the snapshot in the path, from the origin to the destination station.
+     * @param search The state of the query.
+     * @return True if a path exists.
+     * @return False otherwise.
+     */
+    template <class Queue>
+    bool searchWith(int s, int t, std::vector<int>& lines, Search& search) const;
+
+public:
+    /**
+     * @brief Creates an empty hierarchy.
+     */
+    ContractionHierarchy(){};
+
+    /**
+     * @brief Builds the hierarchy of the lines of a service.
+     *
+     * @note Complexity time: roughly O(V log V) witness searches of bounded size for a road-like network.
+     *
+     * @param graph The snapshot.
+     * @param service The service of the lines used.
+     */
+    ContractionHierarchy(const CSRGraph& graph, ServiceMask service);
+
+    /**
+     * @brief Gets the service of the lines in the hierarchy.
+     *
+     * @return The service.
+     */
+    ServiceMask getService() const;
+
+    /**
+     * @brief Gets the number of arcs, including the shortcuts.
+     *
+     * @return The number of arcs.
+     */
+    int getNumArcs() const;
+
+    /**
+     * @brief Finds the minimal cost path between two stations using only the lines of the service of the hierarchy.
+     *
+     * @note The hierarchy is only read, so many threads can search it at the same time, each one with its own state.
+     * @note Complexity time: O(A' log V'), A' and V' being the arcs and stations above both ends in the hierarchy
+     * (plus O(V) the first time the state is used).
+     *
+     * @param s The id of the origin station.
+     * @param t The id of the destination station.
+     * @param lines The lines of the snapshot in the path, from the origin to the destination station. Must be initialized in this function.
+     * @param search The state of the query, kept between the queries of the same thread.
+     * @return True if a path exists.
+     * @return False otherwise.
+     */
+    bool shortestPath(int s, int t, std::vector<int>& lines, Search& search) const;
+
+    /**
+     * @brief Writes the hierarchy to a file.
+     *
+     * @note Complexity time: O(V + A).
+     *
+     * @param path The path of the file.
+     * @return True if the file was written.
+     * @return False otherwise.
+     */
+    bool save(const std::string& path) const;
+
+    /**
+     * @brief Reads a hierarchy from a file.
+     *
+     * @note The file is validated before the hierarchy is changed.
+     * @note Complexity time: O(V + A).
+     *
+     * @param path The path of the file.
+     * @param graph The snapshot the hierarchy must have been built from.
+     * @param service The service the hierarchy must have been built for.
+     * @return True if the file was loaded.
+     * @return False if it does not exist, is corrupted, has another version or was built from another snapshot or service.
+     */
+    bool load(const std::string& path, const CSRGraph& graph, ServiceMask service);
+};
+
+#endif //DA_PROJ1_CONTRACTIONHIERARCHY_H
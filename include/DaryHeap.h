@@ -0,0 +1,305 @@
+#ifndef DA_PROJ1_DARYHEAP_H
+#define DA_PROJ1_DARYHEAP_H
+
+#include <vector>
+#include <utility>
+#include <new>
+#include <cstddef>
+
+/**
+ * @brief The size of a cache line, in bytes.
+ */
+const std::size_t CACHE_LINE_SIZE = 64;
+
+/**
+ * @brief An allocator whose memory starts at the beginning of a cache line.
+ *
+ * @tparam T The type of the objects.
+ */
+template <class T>
+struct CacheAlignedAllocator {
+    typedef T value_type;
+
+    CacheAlignedAllocator() = default;
+
+    template <class U>
+    CacheAlignedAllocator(const CacheAlignedAllocator<U>&) {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(CACHE_LINE_SIZE)));
+    }
+
+    void deallocate(T* p, std::size_t) {
+        ::operator delete(p, std::align_val_t(CACHE_LINE_SIZE));
+    }
+
+    template <class U>
+    bool operator==(const CacheAlignedAllocator<U>&) const { return true; }
+
+    template <class U>
+    bool operator!=(const CacheAlignedAllocator<U>&) const { return false; }
+};
+
+/**
+ * @brief A d-ary min heap of (key, id) pairs, the ids being integers in [0, n).
+ *
+ * Unlike MutablePriorityQueue, the heap keeps the keys themselves next to each other instead of pointers to the
+ * elements, and the position of each id is kept in an array of the heap instead of a field of the elements. A node has
+ * D children, so the heap is log2(D) times shallower, and the children of each node are stored together from the start
+ * of a cache line, so comparing them costs one or two cache misses.
+ *
+ * @note A 4-ary heap of (double, int) pairs has exactly one cache line of children per node.
+ * @tparam Key The type of the keys.
+ * @tparam D The number of children of each node.
+ */
+template <class Key, int D = 4>
+class DaryHeap {
+    static_assert(D >= 2, "a heap needs at least 2 children per node");
+
+    /**
+     * @brief A node of the heap.
+     */
+    struct Entry {
+        Key key;
+        int id;
+        bool operator<(const Entry& entry) const { return key < entry.key; }
+    };
+
+    /**
+     * @brief The number of unused entries before the root, so the children of every node start a cache line when
+     * D entries fill whole cache lines.
+     */
+    static const int OFFSET = D - 1;
+
+    /**
+     * @brief The nodes of the heap: node i is entries[OFFSET + i] and its children are nodes D*i + 1 to D*i + D.
+     */
+    std::vector<Entry, CacheAlignedAllocator<Entry>> entries;
+
+    /**
+     * @brief The node of each id, -1 if it is not in the heap.
+     */
+    std::vector<int> position;
+
+    /**
+     * @brief Moves a node up until its parent is smaller.
+     *
+     * @note Complexity time: O(log_D n).
+     *
+     * @param i The node.
+     */
+    void siftUp(int i);
+
+    /**
+     * @brief Moves a node down until its children are larger.
+     *
+     * @note Complexity time: O(D log_D n).
+     *
+     * @param i The node.
+     */
+    void siftDown(int i);
+
+public:
+    /**
+     * @brief Creates an empty heap for the ids in [0, n).
+     *
+     * @note Complexity time: O(n).
+     *
+     * @param n The number of ids.
+     */
+    explicit DaryHeap(int n = 0);
+
+    /**
+     * @brief Replaces the contents of the heap with the given pairs, building it bottom-up.
+     *
+     * @note Complexity time: O(k), k being the number of pairs, instead of O(k log k) for k insertions.
+     *
+     * @param items The (key, id) pairs. The ids must be distinct.
+     */
+    void heapify(const std::vector<std::pair<Key, int>>& items);
+
+    /**
+     * @brief Inserts an id in the heap.
+     *
+     * @note Complexity time: O(log_D n).
+     *
+     * @param id The id, not yet in the heap.
+     * @param key The key.
+     */
+    void insert(int id, Key key);
+
+    /**
+     * @brief Extracts the id with the minimal key.
+     *
+     * @note Complexity time: O(D log_D n).
+     *
+     * @return The id.
+     */
+    int extractMin();
+
+    /**
+     * @brief Decreases the key of an id in the heap.
+     *
+     * @note Complexity time: O(log_D n).
+     *
+     * @param id The id.
+     * @param key The new key, not larger than the current one.
+     */
+    void decreaseKey(int id, Key key);
+
+    /**
+     * @brief Gets the id with the minimal key, without extracting it.
+     *
+     * @return The id.
+     */
+    int top() const;
+
+    /**
+     * @brief Gets the minimal key.
+     *
+     * @return The key.
+     */
+    Key topKey() const;
+
+    /**
+     * @brief Sees if an id is in the heap.
+     *
+     * @param id The id.
+     * @return True if the id is in the heap.
+     */
+    bool contains(int id) const;
+
+    /**
+     * @brief Returns if the heap is empty.
+     *
+     * @return True if the heap is empty.
+     */
+    bool empty() const;
+
+    /**
+     * @brief Gets the number of ids in the heap.
+     *
+     * @return The number of ids.
+     */
+    int size() const;
+
+    /**
+     * @brief Removes every id from the heap.
+     *
+     * @note Complexity time: O(k), k being the number of ids in the heap.
+     */
+    void clear();
+};
+
+template <class Key, int D>
+DaryHeap<Key, D>::DaryHeap(int n): entries(OFFSET), position(n, -1) {}
+
+template <class Key, int D>
+void DaryHeap<Key, D>::siftUp(int i) {
+    Entry entry = entries[OFFSET + i];
+    while (i > 0) {
+        int parent = (i - 1) / D;
+        if (!(entry < entries[OFFSET + parent])) break;
+        entries[OFFSET + i] = entries[OFFSET + parent];
+        position[entries[OFFSET + i].id] = i;
+        i = parent;
+    }
+    entries[OFFSET + i] = entry;
+    position[entry.id] = i;
+}
+
+template <class Key, int D>
+void DaryHeap<Key, D>::siftDown(int i) {
+    int n = size();
+    Entry entry = entries[OFFSET + i];
+    while (true) {
+        int first = D * i + 1;
+        if (first >= n) break;
+        int last = first + D < n ? first + D : n;
+        int child = first;
+        for (int c = first + 1; c < last; c++) {
+            if (entries[OFFSET + c] < entries[OFFSET + child]) child = c;
+        }
+        if (!(entries[OFFSET + child] < entry)) break;
+        entries[OFFSET + i] = entries[OFFSET + child];
+        position[entries[OFFSET + i].id] = i;
+        i = child;
+    }
+    entries[OFFSET + i] = entry;
+    position[entry.id] = i;
+}
+
+template <class Key, int D>
+void DaryHeap<Key, D>::heapify(const std::vector<std::pair<Key, int>>& items) {
+    clear();
+    for (auto& item : items) {
+        position[item.second] = size();
+        entries.push_back({item.first, item.second});
+    }
+    if (size() < 2) return;
+    //os nos sem filhos ja sao heaps; desce os restantes do ultimo para a raiz
+    for (int i = (size() - 2) / D; i >= 0; i--) {
+        siftDown(i);
+    }
+}
+
+template <class Key, int D>
+void DaryHeap<Key, D>::insert(int id, Key key) {
+    entries.push_back({key, id});
+    siftUp(size() - 1);
+}
+
+template <class Key, int D>
+int DaryHeap<Key, D>::extractMin() {
+    int id = entries[OFFSET].id;
+    position[id] = -1;
+    Entry last = entries.back();
+    entries.pop_back();
+    if (!empty()) {
+        entries[OFFSET] = last;
+        siftDown(0);
+    }
+    return id;
+}
+
+template <class Key, int D>
+void DaryHeap<Key, D>::decreaseKey(int id, Key key) {
+    int i = position[id];
+    entries[OFFSET + i].key = key;
+    siftUp(i);
+}
+
+template <class Key, int D>
+int DaryHeap<Key, D>::top() const {
+    return entries[OFFSET].id;
+}
+
+template <class Key, int D>
+Key DaryHeap<Key, D>::topKey() const {
+    return entries[OFFSET].key;
+}
+
+template <class Key, int D>
+bool DaryHeap<Key, D>::contains(int id) const {
+    return position[id] != -1;
+}
+
+template <class Key, int D>
+bool DaryHeap<Key, D>::empty() const {
+    return size() == 0;
+}
+
+template <class Key, int D>
+int DaryHeap<Key, D>::size() const {
+    return (int) entries.size() - OFFSET;
+}
+
+template <class Key, int D>
+void DaryHeap<Key, D>::clear() {
+    for (int i = 0; i < size(); i++) {
+        position[entries[OFFSET + i].id] = -1;
+    }
+    entries.resize(OFFSET);
+}
+
+#endif //DA_PROJ1_DARYHEAP_H
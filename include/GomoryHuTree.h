@@ -0,0 +1,82 @@
+#ifndef DA_PROJ1_GOMORYHUTREE_H
+#define DA_PROJ1_GOMORYHUTREE_H
+
+#include <vector>
+
+#include "CSRGraph.h"
+#include "MaxFlowEngine.h"
+
+class GomoryHuTree;
+
+/**
+ * @brief An equivalent flow tree (Gusfield's variant of the Gomory-Hu tree) of an undirected railway network.
+ *
+ * The maximum flow between two stations is the minimal weight along the path that connects them in the tree,
+ * so all the pairs of stations can be answered after only V-1 maximum flow computations.
+ */
+class GomoryHuTree {
+    /**
+     * @brief The parent of each station in the tree. The root (station 0) has no parent (-1).
+     */
+    std::vector<int> parent;
+
+    /**
+     * @brief The weight of the tree edge between each station and its parent (the maximum flow between both).
+     */
+    std::vector<double> weight;
+
+    /**
+     * @brief The depth of each station in the tree.
+     */
+    std::vector<int> depth;
+
+    /**
+     * @brief The tree neighbours (parent and children) of each station.
+     */
+    std::vector<std::vector<int>> neighbours;
+
+    /**
+     * @brief The connected component of the network where each station belongs.
+     */
+    std::vector<int> component;
+
+public:
+    /**
+     * @brief Creates an empty tree.
+     */
+    GomoryHuTree(){};
+
+    /**
+     * @brief Builds the tree of an undirected network (see CSRGraph::isUndirected) with Gusfield's algorithm.
+     *
+     * @note Complexity time: V-1 maximum flow computations.
+     *
+     * @param graph The snapshot of the network.
+     * @param engine The engine used to compute the maximum flows.
+     */
+    GomoryHuTree(const CSRGraph& graph, MaxFlowEngine& engine);
+
+    /**
+     * @brief Gets the maximum number of trains that can simultaneously travel between two stations.
+     *
+     * @note Complexity time: O(V).
+     *
+     * @param u The id of the origin station.
+     * @param v The id of the final station, different from the origin station.
+     * @return -1 if there is no path that connects both stations.
+     * @return The maximum flow between both stations otherwise.
+     */
+    double maxFlow(int u, int v) const;
+
+    /**
+     * @brief Gets the maximum number of trains that can simultaneously travel between a station and every other station.
+     *
+     * @note Complexity time: O(V).
+     *
+     * @param u The id of the origin station.
+     * @param flows The maximum flow to each station, -1 for u itself and for the stations that are not connected to u. Must be initialized in this function.
+     */
+    void maxFlowsFrom(int u, std::vector<double>& flows) const;
+};
+
+#endif //DA_PROJ1_GOMORYHUTREE_H
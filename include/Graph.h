@@ -3,26 +3,253 @@
 
 #include <vector>
 #include <queue>
+#include <string>
+#include <unordered_map>
+#include <memory>
 
 #include "StationEdge.h"
+#include "CSRGraph.h"
+#include "MaxFlowEngine.h"
+#include "GomoryHuTree.h"
+#include "ThreadPool.h"
+#include "IncrementalMaxFlow.h"
+#include "PathEngine.h"
+#include "ContractionHierarchy.h"
+#include "ResultCache.h"
+#include "constants.h"
 
 class Graph;
+class QueryContext;
+
+/**
+ * @brief The state that the queries of a graph change while they run: the max flow engine, the searches of the minimal
+ * cost paths and the flow of the what-if queries. The graph creates each part on first use and renews it when the
+ * graph changes.
+ *
+ * The queries that take a context only read the graph, so many threads can answer queries on the same graph at the
+ * same time, each one with its own context (see QueryServer).
+ */
+class QueryContext {
+    friend class Graph;
+
+    /**
+     * @brief The topology version of the graph when the path engine and the what-if flow were created.
+     */
+    std::uint64_t version = 0;
+
+    /**
+     * @brief The algorithm of the engine.
+     */
+    MaxFlowAlgorithm algorithm = EDMONDS_KARP;
+
+    /**
+     * @brief The engine that computes the maximum flows.
+     */
+    std::unique_ptr<MaxFlowEngine> engine;
+
+    /**
+     * @brief The engine that answers the minimal cost path queries when the route index is not loaded.
+     */
+    std::unique_ptr<PathEngine> paths;
+
+    /**
+     * @brief The searches of the STANDARD and ALFA PENDULAR route indexes.
+     */
+    ContractionHierarchy::Search routeSearch[2];
+
+    /**
+     * @brief The maximum flow of the last maxFlowSubGraph call, reused while the origin and destination stay the same.
+     */
+    std::unique_ptr<IncrementalMaxFlow> whatIf;
+};
+
+/**
+ * @brief The attribute used to group the stations into regions, e.g. &Station::getDistrictId or &Station::getLineId.
+ */
+typedef Symbol (Station::*GroupBy)() const;
 
 /**
  * @brief A directed multigraph representing a railway network.
  */
 class Graph {
+    /**
+     * @brief The memory of the stations of the graph.
+     */
+    SlabPool<Station> stationPool;
+
+    /**
+     * @brief The memory of the lines of the graph.
+     */
+    SlabPool<Edge> edgePool;
+
     /**
      * @brief A vector that stores the nodes(stations) of the graph.
      */
     std::vector<Station*> stationSet;
 
+    /**
+     * @brief An index that maps the name of each station to the station itself. Kept up to date by addStation and removeStation.
+     */
+    std::unordered_map<std::string, Station*> stationIndex;
+
+    /**
+     * @brief A CSR snapshot of the graph where maxFlow and maxFlowMinCost are executed.
+     */
+    CSRGraph snapshot;
+
+    /**
+     * @brief True if the graph changed since the snapshot was taken.
+     */
+    bool snapshotOutdated = true;
+
+    /**
+     * @brief The directory of the csv files, the binary dataset and the route index.
+     */
+    std::string datasetDirectory = DATASET_DIRECTORY;
+
+    /**
+     * @brief Incremented by every change of the stations or lines, so the cached results of older versions are never used.
+     */
+    std::uint64_t topologyVersion = 0;
+
+    /**
+     * @brief True if every line of the snapshot has a reverse line with the same capacity (see CSRGraph::isUndirected).
+     */
+    bool undirected = false;
+
+    /**
+     * @brief The algorithm used to compute the maximum flows.
+     */
+    MaxFlowAlgorithm algorithm = EDMONDS_KARP;
+
+    /**
+     * @brief The state of the queries made without a context (the menu, the benchmarks, ...).
+     */
+    QueryContext context;
+
+    /**
+     * @brief The workers that compute many maximum flows in parallel. Created on first use.
+     */
+    std::unique_ptr<ThreadPool> pool;
+
+    /**
+     * @brief One engine per worker of the pool, so every worker keeps its own flow.
+     */
+    std::vector<std::unique_ptr<MaxFlowEngine>> workerEngines;
+
+    /**
+     * @brief The Gomory-Hu tree of the snapshot, used to answer the maximum flow of all the pairs of stations.
+     */
+    GomoryHuTree tree;
+
+    /**
+     * @brief True if the snapshot changed since the tree was built.
+     */
+    bool treeOutdated = true;
+
+    /**
+     * @brief The ids of the stations with a single line, the origin stations of maxFlowGridToStation.
+     */
+    std::vector<int> leaves;
+
+    /**
+     * @brief True if the snapshot changed since the leaves were found.
+     */
+    bool leavesOutdated = true;
+
+    /**
+     * @brief The number of landmarks of the path engine (0 by default, no heuristic).
+     */
+    int numLandmarks = 0;
+
+    /**
+     * @brief The contraction hierarchies of the STANDARD and ALFA PENDULAR lines of the snapshot, used by maxFlowMinCost when loaded.
+     */
+    std::unique_ptr<ContractionHierarchy> routeIndex[2];
+
+    /**
+     * @brief A cached result of maxFlowMinCost.
+     */
+    struct MinCostResult {
+        std::pair<double, double> costAndTrains;
+        std::string service;
+    };
+
+    /**
+     * @brief The results of maxFlow and maxFlows.
+     */
+    ResultCache<double> flowCache;
+
+    /**
+     * @brief The results of maxFlowMinCost.
+     */
+    ResultCache<MinCostResult> minCostCache;
+
+    /**
+     * @brief Gets the key of the maximum flow between two stations of the snapshot. On an undirected network both
+     * directions have the same flow (the same minimum cut), so they share the key.
+     *
+     * @param s The id of the origin station.
+     * @param t The id of the destination station.
+     * @return The key.
+     */
+    CacheKey flowKey(int s, int t) const;
+
+    /**
+     * @brief Computes the result of maxFlowMinCost for two different stations of the snapshot, without the cache.
+     *
+     * @note Complexity time: O(ElogV) in the worst case.
+     *
+     * @param s The id of the origin station.
+     * @param t The id of the destination station.
+     * @param service The service that the path took.
+     * @param context The state of the queries of the calling thread.
+     * @return The cost and the number of trains, {-1, -1} if there is no path.
+     */
+    std::pair<double, double> computeMaxFlowMinCost(int s, int t, std::string& service, QueryContext& context);
+
+    /**
+     * @brief Gets the max flow engine of a context, creating it if it does not use the algorithm of the graph.
+     *
+     * @note Complexity time: O(1).
+     *
+     * @param context The state of the queries.
+     * @return The engine.
+     */
+    MaxFlowEngine& getEngine(QueryContext& context);
+
+    /**
+     * @brief Discards the path engine and the what-if flow of a context if the graph changed since they were created.
+     *
+     * @note Complexity time: O(1).
+     *
+     * @param context The state of the queries.
+     */
+    void refresh(QueryContext& context);
+
+    /**
+     * @brief Gets the path engine of a context, creating it (and its landmarks) if the graph changed.
+     *
+     * @note Complexity time: O(numLandmarks * ElogV) if the graph changed, O(1) otherwise.
+     *
+     * @param context The state of the queries.
+     * @return The engine.
+     */
+    PathEngine& getPathEngine(QueryContext& context);
+
 public:
     /**
      * @brief Creates an empty graph.
      */
     Graph(){};
 
+    /**
+     * @brief Destroys the graph, with all its stations and lines.
+     *
+     * @note Complexity time: O(V + E).
+     */
+    ~Graph();
+
     /**
      * @brief Get the vector where all the stations are stored.
      *
@@ -30,25 +257,172 @@ public:
      *
      * @return A vector containing all the stations of the graph.
      */
-    std::vector<Station*> getStationSet() const;
+    const std::vector<Station*>& getStationSet() const;
+
+    /**
+     * @brief Gets a CSR snapshot of the graph, taking a new one if the graph changed since the last one was taken.
+     *
+     * @note Complexity time: O(V + E) if the graph changed, O(1) otherwise.
+     *
+     * @return The snapshot.
+     */
+    CSRGraph& getSnapshot();
+
+    /**
+     * @brief Gets the Gomory-Hu tree of the graph, building a new one if the graph changed since the last one was built.
+     *
+     * @note Complexity time: V-1 maximum flow computations if the graph changed, O(1) otherwise.
+     *
+     * @return The tree.
+     * @return A null pointer if the graph has lines without a reverse line with the same capacity (the tree only works for undirected networks).
+     */
+    const GomoryHuTree* getGomoryHuTree();
+
+    /**
+     * @brief Gets the ids of the stations with a single line, found once per snapshot.
+     *
+     * @note Complexity time: O(V) if the graph changed, O(1) otherwise.
+     *
+     * @return The ids of the stations.
+     */
+    const std::vector<int>& getLeaves();
+
+    /**
+     * @brief Gets the engine that answers the minimal cost path queries, creating it (and its landmarks) if the graph changed.
+     *
+     * @note Complexity time: O(numLandmarks * ElogV) if the graph changed, O(1) otherwise.
+     *
+     * @return The engine.
+     */
+    PathEngine& getPathEngine();
+
+    /**
+     * @brief Sets the number of landmarks used to guide the minimal cost path queries (ALT). Worth it when many queries are made on the same network.
+     *
+     * @note Complexity time: O(k ElogV) on the next query.
+     *
+     * @param k The number of landmarks. 0 disables the heuristic.
+     */
+    void setNumLandmarks(int k);
+
+    /**
+     * @brief Gets the pool of workers, creating it (and one engine per worker) if needed.
+     *
+     * @return The pool.
+     */
+    ThreadPool& getThreadPool();
+
+    /**
+     * @brief Sets the number of workers used by the parallel computations (one per hardware thread by default).
+     *
+     * @param n The number of workers, including the calling thread.
+     */
+    void setNumThreads(unsigned n);
+
+    /**
+     * @brief Chooses the algorithm used by every maximum flow computation.
+     *
+     * @note Complexity time: O(1).
+     *
+     * @param algorithm The algorithm.
+     */
+    void setMaxFlowAlgorithm(MaxFlowAlgorithm algorithm);
+
+    /**
+     * @brief Gets the topology version: the number of changes of the stations or lines so far.
+     *
+     * @return The version.
+     */
+    std::uint64_t getTopologyVersion() const;
+
+    /**
+     * @brief Changes the number of results kept by each cache (maxFlow and maxFlowMinCost), removing every result.
+     *
+     * @note Complexity time: O(C), C being the number of cached results.
+     *
+     * @param capacity The number of results. 0 disables the caches.
+     */
+    void setCacheCapacity(std::size_t capacity);
+
+    /**
+     * @brief Gets the hits, misses and number of entries of the result caches, added together.
+     *
+     * @note Complexity time: O(1).
+     *
+     * @return The statistics.
+     */
+    CacheStats getCacheStats();
+
+    /**
+     * @brief Changes the directory of the dataset read by fill, readStations and readNetwork, where the binary dataset
+     * and the route index are also stored. The graph is not modified.
+     *
+     * @param directory The directory.
+     */
+    void setDatasetDirectory(const std::string& directory);
+
+    /**
+     * @brief Gets the path of a file of the dataset directory.
+     *
+     * @param name The name of the file (e.g. STATIONS_FILE_NAME).
+     * @return The path.
+     */
+    std::string getDatasetPath(const std::string& name) const;
 
     /**
      * @brief Populates the graph with the information from the csv files in the dataset.
      *
-     * @note Complexity time: O(V^2).
+     * @note If the graph is empty and the binary dataset (see saveBinaryDataset) was converted from the current csv files,
+     * it is loaded instead. Otherwise the csv files are parsed. The route index is then loaded if it was built (see
+     * loadRouteIndex). Nothing is written into the dataset directory.
+     * @note The binary dataset only saves the parsing of the csv files (splitting, unquoting and converting the fields):
+     * the stations and lines are still created one at a time, so loading it costs O(V + E) allocations, not just the
+     * reading of the file.
+     * @note Complexity time: O(V + E).
      */
     void fill();
 
+    /**
+     * @brief Writes the binary dataset of the csv files of the dataset directory, so the next fill loads it instead of
+     * parsing them (see the --convert option).
+     *
+     * @note The graph must have been read from the csv files of the dataset directory, and not changed since.
+     * @note Complexity time: O(V + E).
+     *
+     * @return True if the file was written.
+     * @return False otherwise.
+     */
+    bool saveBinaryDataset() const;
+
+    /**
+     * @brief Loads the contraction hierarchies of the STANDARD and ALFA PENDULAR lines from the dataset directory. A
+     * hierarchy that is missing or was built from another network is not loaded, and its service is answered by PathEngine.
+     *
+     * @note The hierarchies are dropped as soon as the graph changes; maxFlowMinCost then goes back to PathEngine.
+     * @note Complexity time: O(V + E).
+     */
+    void loadRouteIndex();
+
+    /**
+     * @brief Loads the contraction hierarchies of the STANDARD and ALFA PENDULAR lines like loadRouteIndex, building
+     * (and saving into the dataset directory) the ones that are missing or were built from another network.
+     *
+     * @note Complexity time: O(V + E) to load, the contraction of every station to build.
+     */
+    void buildRouteIndex();
+
     /**
      * @brief Reads the stations from the file and adds them into the graph.
      *
-     * @note Complexity time: O(V^2).
+     * @note Rows without 5 fields are reported to the standard error with their line number and skipped.
+     * @note Complexity time: O(V).
      */
     void readStations();
 
     /**
      * @brief Reads the Network(Edges) from the file and adds them into the graph.
      *
+     * @note Rows without 4 fields or with an invalid capacity are reported to the standard error with their line number and skipped.
      * @note Complexity time: O(E).
      */
     void readNetwork();
@@ -56,7 +430,8 @@ public:
     /**
      * @brief Removes a station from the graph.
      *
-     * @note Complexity time: O(V + E^2).
+     * @note Each line of the station is unlinked in constant time, only the list of stations is shifted.
+     * @note Complexity time: O(V + deg), deg being the number of lines of the station.
      *
      * @param station The station that is going to be removed.
      * @return True if the station was successfully removed.
@@ -65,7 +440,7 @@ public:
     bool removeStation(const Station* station);
 
     /**
-     * @brief Adds a station to the graph.
+     * @brief Adds a station to the graph if there is no station with the same name.
      *
      * @note Complexity time: O(1).
      *
@@ -91,12 +466,12 @@ public:
      * @return True if the line was successfully added.
      * @return False otherwise.
      */
-    bool addLine(const std::string& origin, const std::string& dest, const double& capacity, const std::string& service);
+    bool addLine(const std::string& origin, const std::string& dest, const double& capacity, ServiceMask service);
 
     /**
      * @brief Gets a station with a given name if it exists.
      *
-     * @note Complexity time: O(V).
+     * @note Complexity time: O(1).
      *
      * @param name The name of the station.
      * @return The station if it exists.
@@ -107,7 +482,7 @@ public:
     /**
      * @brief Adds a bidirectional line to a graph.
      *
-     * @note Complexity time: O(V).
+     * @note Complexity time: O(1).
      *
      * @param origin The origin of the line.
      * @param dest The destination of the line.
@@ -116,13 +491,14 @@ public:
      * @return True if the line was successfully added.
      * @return False otherwise.
      */
-    bool addBidirectionalLine(const std::string& origin, const std::string& dest, const double& capacity, const std::string& service);
+    bool addBidirectionalLine(const std::string& origin, const std::string& dest, const double& capacity, ServiceMask service);
 
     /**
-     * @brief Gets the maximum number of trains that can simultaneously travel between two stations by apllying the Edmonds-Karp Algorithm.
+     * @brief Gets the maximum number of trains that can simultaneously travel between two stations by apllying the chosen max flow algorithm (Edmonds-Karp by default).
      *
      * @note This function was implemented by Gonçalo Leão.
-     * @note Complexity time: O(VE^2)
+     * @note The results are cached until the stations or lines change (see getCacheStats).
+     * @note Complexity time: O(VE^2) with Edmonds-Karp, O(V^2E) with Dinic, O(1) for a cached pair.
      *
      * @param source The name of the origin station.
      * @param target The name of the final station.
@@ -133,148 +509,128 @@ public:
     double maxFlow(const std::string& source, const std::string& target);
 
     /**
-     * @brief Finds an augmenting path between two stations.
+     * @brief Same as maxFlow, with the state of the calling thread, so many threads can use the graph at the same time.
      *
-     * @note This function was implemented by Gonçalo Leão.
-     * @note Complexity time: O(V+E).
+     * @note The graph must not change while the queries run (see QueryContext).
      *
-     * @param s The origin station.
-     * @param t The final station.
-     * @return True if exists an augmenting path.
-     * @return False otherwise.
-     */
-    bool findAugmentingPath(Station* s, Station* t);
-
-    /**
-     * @brief Calculates how much more flow is allowed in each edge of the augmenting path.
-     *
-     * @note This function was implemented by Gonçalo Leão.
-     * @note Complexity time: O(E).
-     *
-     * @param s The origin station.
-     * @param t The destination station.
-     * @return The minimal residual flow.
-     */
-    double findMinResidualAlongPath(Station* s, Station* t);
-
-    /**
-     * @brief Finds the flow of a augmented path.
-     *
-     * @note This function was implemented by Goncaçalo Leão.
-     * @note Complexity time: O(E).
-     *
-     * @param s The origin station.
-     * @param t The destination station.
-     * @param f The minimal residual flow of this augmented path.
-     */
-    void augmentFlowAlongPath(Station* s, Station* t, double f);
-
-    /**
-     * @brief This function evaluates if the staion w is optimal to insert into the queue. (BFS)
-     *
-     * @note This function was implemented by Gonçalo Leão.
-     * @note Complexity time: O(1).
-     *
-     * @param q Queue where we are going to add stations.
-     * @param e Edge that we took to get to station w.
-     * @param w Station we are going to evaluate.
-     * @param residual The remaining capacity of the station w.
+     * @param source The name of the origin station.
+     * @param target The name of the final station.
+     * @param context The state of the queries of the thread.
+     * @return The same as maxFlow.
      */
-    void testAndVisit(std::queue<Station*>& q, Edge* e, Station* w, double residual);
+    double maxFlow(const std::string& source, const std::string& target, QueryContext& context);
 
     /**
-     * @brief Aplly the DFS algorithm to see if a path between source and dest exist. We can apply DFS in all paths, STANDARD paths and ALFA PENDULAR paths.
+     * @brief Aplly the DFS algorithm (on the snapshot) to see if a path between source and dest exist, using only the lines of the given services.
      *
      * @note Complexity time: O(V+E)
      *
      * @param source The origin station's name
      * @param dest The destination station's name
-     * @param service The service we want to execute the DFS. "All" executes dfs in all paths. "Standard" executes dfs only in standard paths. "ALFA PENDULAR" executes dfs only in alfa pendular paths.
+     * @param services The services we want to execute the DFS in. SERVICE_ALL executes dfs in all paths, SERVICE_STANDARD only in standard paths and SERVICE_ALFA_PENDULAR only in alfa pendular paths.
      * @return True if a path exists.
      * @return False otherwise.
      */
-    bool dfs(const std::string& source, const std::string& dest, const std::string& service);
+    bool dfs(const std::string& source, const std::string& dest, ServiceMask services);
 
     /**
-     * @brief Executes the "heavy work" of the dfs algorithm in all paths.
+     * @brief Gets the maximum number of trains that can simultaneously travel between many pairs of stations, in parallel.
      *
-     * @note Complexity time: O(V+E).
+     * @note When there are at least as many pairs as stations (or the tree is already built) and the graph is undirected, the flows are read from the Gomory-Hu tree.
+     * Otherwise the flows are shared with the cache of maxFlow.
+     * @note Complexity time: O(P * VE^2 / W) with P pairs and W workers.
      *
-     * @param s The origin station.
-     * @param dest The destination station's name.
-     * @return True if a path exists.
-     * @return False otherwise.
+     * @param pairs The pairs of stations (origin and destination).
+     * @return The flow of each pair, in the same order: -2 if a station does not exist or both are the same, -1 if there is no path that connects them.
      */
-    bool dfsVisit(Station* s, const std::string& dest);
+    std::vector<double> maxFlows(const std::vector<std::pair<Station*, Station*>>& pairs);
 
     /**
-     * @brief Executes the "heavy work" of the dfs algorithm in "ALFA PENDULAR" paths.
+     * @brief Finds the pair of stations that require the most amount of trains, using the Gomory-Hu tree of the graph (or executing the max flow algorithm in all pair of stations if the graph is not undirected).
      *
-     * @note Complexity time: O(V+E).
+     * @note Complexity time: O(V^2) plus V-1 maximum flow computations.
      *
-     * @param s The origin station.
-     * @param dest The destination station's name.
-     * @return True if a path exists.
-     * @return False otherwise.
+     * @return A vector containing the number of trains and the pair of station's name.
      */
-    bool dfsVisitAlfaPendular(Station* s, const std::string& dest);
+    std::vector<std::pair<double, std::pair<std::string, std::string>>> fullMaxFlow();
 
     /**
-     * @brief Executes the "heavy work" of the dfs algorithm in "STANDARD" paths.
+     * @brief Finds the top (n) regions with the most flow of trains: the maximum flow between every pair of stations of the
+     * region plus the capacity of every line that arrives at one of its stations.
      *
-     * @note Complexity time: O(V+E).
+     * @note The stations are grouped by region first, so only the pairs inside the same region are computed.
+     * @note Complexity time: O(V + E + sum k^2) plus V-1 maximum flow computations, k being the number of stations of each region.
+     * With inducedSubgraph, k-1 maximum flow computations on the subgraph of each region instead (in parallel).
      *
-     * @param s The origin station.
-     * @param dest The destination station's name.
-     * @return True if a path exists.
-     * @return False otherwise.
+     * @param groupBy The attribute that identifies the region of a station.
+     * @param n The number of regions that we want to see.
+     * @param inducedSubgraph If true, the flows between the stations of a region only use the stations and lines of that region.
+     * @return A vector containing a pair with the region name and the respective flow of trains.
      */
-    bool dfsVisitStandard(Station* s, const std::string& dest);
+    std::vector<std::pair<std::string, double>> topRegions(GroupBy groupBy, int n, bool inducedSubgraph = false);
 
     /**
-     * @brief Executes the Edmonds-Karp algorithm in all pair of stations to find the pair of stations that require the most amount of trains.
+     * @brief Finds the top (n) districts with the most flow of trains, using the Gomory-Hu tree of the graph.
      *
-     * @note Complexity time: O(V^3 * E^2).
+     * @note Complexity time: O(V + E + sum k^2) plus V-1 maximum flow computations, k being the number of stations of each district.
      *
-     * @return A vector containing the number of trains and the pair of station's name.
+     * @param n The number of the districts that we want to see.
+     * @return A vector containing a pair with the district name and the respective flow of trains.
      */
-    std::vector<std::pair<double, std::pair<std::string, std::string>>> fullMaxFlow();
+    std::vector<std::pair<std::string, double>> topDistricts(int n);
 
     /**
-     * @brief Executes the Edmonds-Karp algorithm to find the top (n) districts with the most flow of trains.
+     * @brief Finds the top (n) municipalities with the most flow of trains, using the Gomory-Hu tree of the graph.
      *
-     * @note Complexity time: O(V^3 * E^2).
+     * @note Complexity time: O(V + E + sum k^2) plus V-1 maximum flow computations, k being the number of stations of each municipality.
      *
-     * @param n The number of the districts that we want to see.
-     * @return A vector containing a pair with the district name and the respective flow of trains.
+     * @param n The number of the municipalities that we want to see.
+     * @return A vector containing a pair with the municipality name and the respective flow of trains.
      */
-    std::vector<std::pair<std::string, double>> topDistricts(int n);
+    std::vector<std::pair<std::string, double>> topMunicipalities(int n);
 
     /**
-     * @brief Executes the Edmonds-Karp algorithm to find the top (n) municipalities with the most flow of trains.
+     * @brief Calculates the maximum number of trains that can simultaneously arrive at each of the given stations from a set of stations, in parallel.
      *
-     * @note Complexity time: O(V^3 * E^2).
+     * @note The origin stations work as a virtual super source, the graph is not modified.
+     * @note Complexity time: O(VE^2) per station.
      *
-     * @param n The number of the districts that we want to see.
-     * @return A vector containing a pair with the district name and the respective flow of trains.
+     * @param sources The ids of the origin stations in the current snapshot. A station is never an origin of its own flow.
+     * @param targets The final stations.
+     * @return The max flow of each final station, -1 if no origin station reaches it or -2 if the station is not valid.
      */
-    std::vector<std::pair<std::string, double>> topMunicipalities(int n);
+    std::vector<double> maxFlowsFromSources(const std::vector<int>& sources, const std::vector<Station*>& targets);
 
     /**
      * @brief Finds the maximum number of trains that can travel simultaneously to a specific station from the entire railway network.
      *
+     * @note The trains come from every station with a single line (the ends of the network). The graph is not modified.
      * @note Complexity time: O(VE^2).
      *
      * @param dest The name of the station.
-     * @return
+     * @return The max flow, -1 if the station does not exist or can not be reached.
      */
     double maxFlowGridToStation(const std::string& dest);
 
+    /**
+     * @brief Same as maxFlowGridToStation, with the state of the calling thread, so many threads can use the graph at the same time.
+     *
+     * @note The graph must not change while the queries run, and getLeaves must have been called since it last changed.
+     *
+     * @param dest The name of the station.
+     * @param context The state of the queries of the thread.
+     * @return The same as maxFlowGridToStation.
+     */
+    double maxFlowGridToStation(const std::string& dest, QueryContext& context);
+
     /**
      * @brief Finds the path that connects two stations which cost less to the company while maximizes the number of trains that can travel.
      *
      * @note If there is no path that connects the origin station and the destination station, the service will be uninitialized.
-     * @note Complexity time: O(ElogV)
+     * @note Each service queries its contraction hierarchy if loaded (see loadRouteIndex and buildRouteIndex), or runs a bidirectional
+     * search (see PathEngine) otherwise. Both also detect when there is no path.
+     * @note The results are cached until the stations or lines change (see getCacheStats).
+     * @note Complexity time: O(ElogV) in the worst case, O(1) for a cached pair.
      *
      * @param origin The origin station's name.
      * @param dest The destination station's name.
@@ -283,10 +639,24 @@ public:
      */
     std::pair<double, double> maxFlowMinCost(const std::string& origin, const std::string& dest, std::string& service);
 
+    /**
+     * @brief Same as maxFlowMinCost, with the state of the calling thread, so many threads can use the graph at the same time.
+     *
+     * @note The graph must not change while the queries run (see QueryContext).
+     *
+     * @param origin The origin station's name.
+     * @param dest The destination station's name.
+     * @param service The service that the path took.
+     * @param context The state of the queries of the thread.
+     * @return The same as maxFlowMinCost.
+     */
+    std::pair<double, double> maxFlowMinCost(const std::string& origin, const std::string& dest, std::string& service, QueryContext& context);
+
     /**
      * @brief Calculates the maximum number of trains that can simultaneously travel between two stations by apllying the Edmonds-Karp Algorithm in a subgraph.
      *
-     * @note Complexity time: O(VE^2)
+     * @note The graph is not modified: the maximum flow of the full network is kept and only re-optimised around the removed lines, so consecutive calls with the same stations are cheap.
+     * @note Complexity time: O(VE^2) for the first call, a few augmentations per removed line afterwards.
      *
      * @param linesToRemove A vector that contains a pair of the station's name that are going to have the edges that connect them removed.
      * @param origin The origin station's name.
@@ -296,20 +666,24 @@ public:
     double maxFlowSubGraph(const std::vector<std::pair<std::string, std::string>>& linesToRemove, const std::string& origin, const std::string& dest);
 
     /**
-     * @brief Finds the minimal cost path between two stations. We can apply in "STANDARD" paths and "ALFA PENDULAR" paths.
+     * @brief Same as maxFlowSubGraph, with the state of the calling thread, so many threads can use the graph at the same time.
      *
-     * @note Complexity time: O(ElogV)
+     * @note The graph must not change while the queries run (see QueryContext).
      *
-     * @param source The origin station.
-     * @param dest The destination station.
-     * @param service The service we want to execute the Dijkstra. It can either be "STANDARD" or "ALFA PENDULAR".
+     * @param linesToRemove A vector that contains a pair of the station's name that are going to have the edges that connect them removed.
+     * @param origin The origin station's name.
+     * @param dest The destination station's name.
+     * @param context The state of the queries of the thread.
+     * @return The same as maxFlowSubGraph.
      */
-    void dijkstra(Station* source, Station* dest, const std::string& service);
+    double maxFlowSubGraph(const std::vector<std::pair<std::string, std::string>>& linesToRemove, const std::string& origin, const std::string& dest, QueryContext& context);
 
     /**
      * @brief Provides the top (n) stations that were affected by the lines removed.
      *
-     * @note Complexity time: O(V^2 * E^3)
+     * @note The super source of maxFlowGridToStation is wired once, the flow of each station is computed once and each
+     * removed line only re-optimises it when the line carried flow. The graph is not modified.
+     * @note Complexity time: O(V^2 E^2) for the flows of the full network, a few augmentations per station and removed line afterwards.
      *
      * @param linesToRemove A vector that contains a pair of the station's name that are going to have the edges that connect them removed.
      * @param n The number of stations that we want to see affected.
@@ -317,18 +691,6 @@ public:
      * @return A vector containing a pair which have the station and the number of trains affected.
      */
     std::vector<std::vector<std::pair<Station*, double>>> topStationsAffected(const std::vector<std::pair<std::string, std::string>> &linesToRemove, const int n, bool& error);
-
-    /**
-     * @brief Calculate the maximum number of trains that can travel between a specific path.
-     *
-     * @note Complexity time: O(E).
-     *
-     * @param origin The origin station.
-     * @param dest The destination station.
-     * @param nPath The number of lines that it took to get to the destination station. Must be initialized in this function.
-     * @return The maximum number of trains that can travel from origin to dest.
-     */
-    double calculateCost(Station* origin, Station* dest, int& nPath) const;
 };
 
-#endif
\ No newline at end of file
+#endif
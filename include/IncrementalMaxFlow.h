@@ -0,0 +1,217 @@
+#ifndef DA_PROJ1_INCREMENTALMAXFLOW_H
+#define DA_PROJ1_INCREMENTALMAXFLOW_H
+
+#include <vector>
+
+#include "CSRGraph.h"
+
+class IncrementalMaxFlow;
+
+/**
+ * @brief Keeps a maximum flow between two stations up to date while lines of the network fail and are restored.
+ *
+ * The maximum flow is computed once on the intact network. Removing a line only cancels the flow that went through
+ * it (rerouting it when possible) and augments from there, instead of computing everything from zero flow.
+ * Failed lines are masked as inactive, the snapshot itself is never modified.
+ */
+class IncrementalMaxFlow {
+    /**
+     * @brief The snapshot of the network.
+     */
+    const CSRGraph* graph;
+
+    /**
+     * @brief The id of the origin station.
+     */
+    int s;
+
+    /**
+     * @brief The id of the final station.
+     */
+    int t;
+
+    /**
+     * @brief The current maximum flow between both stations.
+     */
+    double value;
+
+    /**
+     * @brief The flow of each line (skew-symmetric).
+     */
+    std::vector<double> flow;
+
+    /**
+     * @brief False for the lines that failed.
+     */
+    std::vector<bool> active;
+
+    /**
+     * @brief The lines that never carry flow, not even after restoreLines.
+     */
+    std::vector<int> excluded;
+
+    /**
+     * @brief The excluded lines that were included since the last call to restoreLines.
+     */
+    std::vector<int> included;
+
+    /**
+     * @brief True if some line failed or was included since the last call to restoreLines.
+     */
+    bool hasChanges;
+
+    /**
+     * @brief True if some line that was deactivated since the last call to restoreLines carried flow.
+     */
+    bool flowChanged;
+
+    /**
+     * @brief The line taken to get to each station in the last augmenting path.
+     */
+    std::vector<int> path;
+
+    /**
+     * @brief The stations visited by the last BFS.
+     */
+    std::vector<bool> visited;
+
+    /**
+     * @brief The BFS queue.
+     */
+    std::vector<int> queue;
+
+    /**
+     * @brief Gets how much more flow is allowed in a line. Inactive lines allow no flow.
+     *
+     * @note Complexity time: O(1).
+     *
+     * @param e The index of the line.
+     * @return The residual capacity.
+     */
+    double residual(int e) const { return active[e] ? graph->getCapacity(e) - flow[e] : 0; }
+
+    /**
+     * @brief Finds a path with residual capacity between two stations (BFS).
+     *
+     * @note Complexity time: O(V+E).
+     *
+     * @param from The id of the station where the path starts.
+     * @param to The id of the station where the path ends.
+     * @param virtualLine If true, the path may also use a virtual line from the final station to the origin station, whose flow is the maximum flow.
+     * @return True if the path exists.
+     * @return False otherwise.
+     */
+    bool findAugmentingPath(int from, int to, bool virtualLine);
+
+    /**
+     * @brief Sends flow between two stations along augmenting paths (Edmonds-Karp).
+     *
+     * @note Complexity time: O(VE^2).
+     *
+     * @param from The id of the station where the flow starts.
+     * @param to The id of the station where the flow ends.
+     * @param limit The maximum flow to send.
+     * @param virtualLine If true, the paths may also use the virtual line from the final station to the origin station (updating the maximum flow).
+     * @return The flow that was sent.
+     */
+    double augment(int from, int to, double limit, bool virtualLine);
+
+    /**
+     * @brief Deactivates a line and its reverse, rerouting or cancelling the flow that went through them.
+     *
+     * @note Complexity time: a few augmentations.
+     *
+     * @param e The index of the line.
+     * @return True if the line or its reverse carried flow.
+     * @return False otherwise.
+     */
+    bool deactivate(int e);
+
+    /**
+     * @brief Finds the first active line of the network (not a residual line) between two stations.
+     *
+     * @note Complexity time: O(deg(u)).
+     *
+     * @param u The id of the station where the line starts.
+     * @param v The id of the station where the line ends.
+     * @return The index of the line, -1 if it does not exist.
+     */
+    int findLine(int u, int v) const;
+
+public:
+    /**
+     * @brief Computes the maximum flow between two stations in the intact network.
+     *
+     * @note Complexity time: O(VE^2).
+     *
+     * @param graph The snapshot of the network. Must outlive this object.
+     * @param s The id of the origin station.
+     * @param t The id of the final station.
+     * @param excludedLines Lines (with their reverses) that are left out of the network.
+     */
+    IncrementalMaxFlow(const CSRGraph& graph, int s, int t, const std::vector<int>& excludedLines = std::vector<int>());
+
+    /**
+     * @brief Gets the id of the origin station.
+     *
+     * @return The id.
+     */
+    int getSource() const;
+
+    /**
+     * @brief Gets the id of the final station.
+     *
+     * @return The id.
+     */
+    int getTarget() const;
+
+    /**
+     * @brief Gets the maximum flow between both stations in the network without the failed lines.
+     *
+     * @note Complexity time: O(1).
+     *
+     * @return The maximum flow.
+     */
+    double getMaxFlow() const;
+
+    /**
+     * @brief Removes the line between two stations in both directions, as Station::removeAndStoreEdge does, and updates the maximum flow.
+     *
+     * @note Complexity time: a few augmentations.
+     *
+     * @param u The id of one of the stations.
+     * @param v The id of the other station.
+     * @return True if there was a line between the stations.
+     * @return False otherwise.
+     */
+    bool removeLine(int u, int v);
+
+    /**
+     * @brief Adds one of the excluded lines (and its reverse) to the network until the next call to restoreLines, and updates the maximum flow.
+     *
+     * @note Complexity time: a few augmentations.
+     *
+     * @param e The index of the excluded line.
+     */
+    void includeLine(int e);
+
+    /**
+     * @brief Restores every failed line, removes the included lines and updates the maximum flow.
+     *
+     * @note If none of the removed lines carried flow, the flow is still maximum and nothing is augmented.
+     * @note Complexity time: a few augmentations.
+     */
+    void restoreLines();
+
+    /**
+     * @brief Sees if there is a path between both stations without the failed lines.
+     *
+     * @note Complexity time: O(V+E).
+     *
+     * @return True if a path exists.
+     * @return False otherwise.
+     */
+    bool isConnected() const;
+};
+
+#endif //DA_PROJ1_INCREMENTALMAXFLOW_H
@@ -0,0 +1,364 @@
+#ifndef DA_PROJ1_MAXFLOWENGINE_H
+#define DA_PROJ1_MAXFLOWENGINE_H
+
+#include <vector>
+#include <string>
+
+#include "CSRGraph.h"
+
+class MaxFlowEngine;
+
+/**
+ * @brief The algorithms that can be used to compute a maximum flow.
+ */
+enum MaxFlowAlgorithm {
+    EDMONDS_KARP,
+    DINIC,
+    PUSH_RELABEL
+};
+
+/**
+ * @brief Gets the algorithm with a given name ("edmonds-karp", "dinic" or "push-relabel").
+ *
+ * @note Complexity time: O(1).
+ *
+ * @param name The name of the algorithm.
+ * @param algorithm The algorithm. Initialized only if the name is valid.
+ * @return True if the name is valid.
+ * @return False otherwise.
+ */
+bool parseMaxFlowAlgorithm(const std::string& name, MaxFlowAlgorithm& algorithm);
+
+/************************* MaxFlowEngine  **************************/
+
+/**
+ * @brief Computes maximum flows on a CSRGraph snapshot.
+ *
+ * An engine keeps the flow of every line of the last snapshot it ran on, so the snapshot itself is never modified.
+ */
+class MaxFlowEngine {
+    /**
+     * @brief The origin station of a maximum flow with a single origin.
+     */
+    std::vector<int> single;
+
+protected:
+    /**
+     * @brief The flow of each line of the snapshot.
+     *
+     * @note The flow is skew-symmetric: the flow of a line is always the symmetric of the flow of its reverse.
+     */
+    std::vector<double> flow;
+
+    /**
+     * @brief Gets how much more flow is allowed in a line.
+     *
+     * @note Complexity time: O(1).
+     *
+     * @param graph The snapshot.
+     * @param e The index of the line.
+     * @return The residual capacity.
+     */
+    double residual(const CSRGraph& graph, int e) const { return graph.getCapacity(e) - flow[e]; }
+
+    /**
+     * @brief Sends flow along a line (and takes it from its reverse).
+     *
+     * @note Complexity time: O(1).
+     *
+     * @param graph The snapshot.
+     * @param e The index of the line.
+     * @param f The flow.
+     */
+    void push(const CSRGraph& graph, int e, double f) { flow[e] += f; flow[graph.getReverse(e)] -= f; }
+
+    /**
+     * @brief True for the origin stations of the current maximum flow.
+     */
+    std::vector<bool> isSource;
+
+    /**
+     * @brief Marks the origin stations of a maximum flow, leaving out the final station.
+     *
+     * @note Complexity time: O(V).
+     *
+     * @param graph The snapshot.
+     * @param sources The ids of the origin stations.
+     * @param t The id of the final station.
+     */
+    void markSources(const CSRGraph& graph, const std::vector<int>& sources, int t);
+
+public:
+    virtual ~MaxFlowEngine(){};
+
+    /**
+     * @brief Gets the maximum number of trains that can simultaneously travel between two stations.
+     *
+     * @param graph The snapshot.
+     * @param s The id of the origin station.
+     * @param t The id of the final station.
+     * @return The maximum flow between both stations.
+     */
+    double maxFlow(const CSRGraph& graph, int s, int t);
+
+    /**
+     * @brief Gets the maximum number of trains that can simultaneously arrive at a station from a set of stations.
+     *
+     * @note Works as a virtual super source connected to every origin station by lines with unlimited capacity, without modifying the snapshot.
+     * @note The final station is ignored if it is one of the origin stations.
+     *
+     * @param graph The snapshot.
+     * @param sources The ids of the origin stations.
+     * @param t The id of the final station.
+     * @return The maximum flow between the origin stations and the final station.
+     */
+    virtual double maxFlow(const CSRGraph& graph, const std::vector<int>& sources, int t) = 0;
+
+    /**
+     * @brief Creates an engine that executes the given algorithm.
+     *
+     * @param algorithm The algorithm.
+     * @return The engine. The caller owns it.
+     */
+    static MaxFlowEngine* create(MaxFlowAlgorithm algorithm);
+
+    /**
+     * @brief Finds the source side of a minimum cut after a maximum flow computation: the stations that can not reach the final station in the residual graph.
+     *
+     * @note Complexity time: O(V+E).
+     *
+     * @param graph The snapshot where the last maximum flow was computed.
+     * @param t The id of the final station of the last maximum flow.
+     * @param sourceSide True for each station in the source side of the cut. Must be initialized in this function.
+     */
+    void minCut(const CSRGraph& graph, int t, std::vector<bool>& sourceSide) const;
+};
+
+/************************* EdmondsKarp  **************************/
+
+/**
+ * @brief Computes maximum flows with the Edmonds-Karp algorithm (shortest augmenting paths).
+ *
+ * @note Adapted from the implementation by Gonçalo Leão.
+ */
+class EdmondsKarp : public MaxFlowEngine {
+    /**
+     * @brief The line taken to get to each station in the last augmenting path.
+     */
+    std::vector<int> path;
+
+    /**
+     * @brief The stations visited by the last BFS.
+     */
+    std::vector<bool> visited;
+
+    /**
+     * @brief The BFS queue.
+     */
+    std::vector<int> queue;
+
+public:
+    using MaxFlowEngine::maxFlow;
+
+    /**
+     * @brief Gets the maximum number of trains that can simultaneously arrive at a station from a set of stations.
+     *
+     * @note Complexity time: O(VE^2).
+     *
+     * @param graph The snapshot.
+     * @param sources The ids of the origin stations.
+     * @param t The id of the final station.
+     * @return The maximum flow between the origin stations and the final station.
+     */
+    double maxFlow(const CSRGraph& graph, const std::vector<int>& sources, int t) override;
+
+    /**
+     * @brief Finds an augmenting path between one of the origin stations and the final station (BFS).
+     *
+     * @note Complexity time: O(V+E).
+     *
+     * @param graph The snapshot.
+     * @param sources The ids of the origin stations.
+     * @param t The id of the final station.
+     * @return True if exists an augmenting path.
+     * @return False otherwise.
+     */
+    bool findAugmentingPath(const CSRGraph& graph, const std::vector<int>& sources, int t);
+
+    /**
+     * @brief Calculates how much more flow is allowed in each line of the augmenting path.
+     *
+     * @note Complexity time: O(E).
+     *
+     * @param graph The snapshot.
+     * @param t The id of the destination station.
+     * @return The minimal residual flow.
+     */
+    double findMinResidualAlongPath(const CSRGraph& graph, int t) const;
+
+    /**
+     * @brief Augments the flow of every line of the augmenting path.
+     *
+     * @note Complexity time: O(E).
+     *
+     * @param graph The snapshot.
+     * @param t The id of the destination station.
+     * @param f The minimal residual flow of this augmented path.
+     */
+    void augmentFlowAlongPath(const CSRGraph& graph, int t, double f);
+};
+
+/************************* Dinic  **************************/
+
+/**
+ * @brief Computes maximum flows with Dinic's algorithm (level graph + blocking flow).
+ */
+class Dinic : public MaxFlowEngine {
+    /**
+     * @brief The distance from the origin station to each station in the residual graph.
+     */
+    std::vector<int> level;
+
+    /**
+     * @brief The next line to be explored from each station in the current blocking flow.
+     */
+    std::vector<int> current;
+
+    /**
+     * @brief The BFS queue.
+     */
+    std::vector<int> queue;
+
+    /**
+     * @brief The lines of the path being explored from the origin station in the level graph (DFS stack).
+     */
+    std::vector<int> path;
+
+    /**
+     * @brief Builds the level graph (BFS), where every origin station has level 0.
+     *
+     * @note Complexity time: O(V+E).
+     *
+     * @param graph The snapshot.
+     * @param sources The ids of the origin stations.
+     * @param t The id of the final station.
+     * @return True if the final station is reachable in the residual graph.
+     * @return False otherwise.
+     */
+    bool buildLevels(const CSRGraph& graph, const std::vector<int>& sources, int t);
+
+    /**
+     * @brief Sends flow from an origin station to the final station along one path of the level graph (DFS with an
+     * explicit stack, since the levels can be as deep as the number of stations).
+     *
+     * @note Complexity time: O(VE) for all the calls of one blocking flow.
+     *
+     * @param graph The snapshot.
+     * @param s The id of the origin station.
+     * @param t The id of the final station.
+     * @return The flow that was sent, 0 if the final station can not be reached anymore.
+     */
+    double sendFlow(const CSRGraph& graph, int s, int t);
+
+public:
+    using MaxFlowEngine::maxFlow;
+
+    /**
+     * @brief Gets the maximum number of trains that can simultaneously arrive at a station from a set of stations.
+     *
+     * @note Complexity time: O(V^2 E).
+     *
+     * @param graph The snapshot.
+     * @param sources The ids of the origin stations.
+     * @param t The id of the final station.
+     * @return The maximum flow between the origin stations and the final station.
+     */
+    double maxFlow(const CSRGraph& graph, const std::vector<int>& sources, int t) override;
+};
+
+/************************* PushRelabel  **************************/
+
+/**
+ * @brief Computes maximum flows with the highest-label push-relabel algorithm, using the gap and global relabeling heuristics.
+ *
+ * @note Only the first phase is executed, so the flow of the lines is a preflow: the maximum flow is the excess of the final station.
+ */
+class PushRelabel : public MaxFlowEngine {
+    /**
+     * @brief The height (label) of each station.
+     */
+    std::vector<int> height;
+
+    /**
+     * @brief The excess flow of each station.
+     */
+    std::vector<double> excess;
+
+    /**
+     * @brief The next line to be explored from each station.
+     */
+    std::vector<int> current;
+
+    /**
+     * @brief The number of stations with each height.
+     */
+    std::vector<int> count;
+
+    /**
+     * @brief The active stations (with excess) of each height.
+     */
+    std::vector<std::vector<int>> active;
+
+    /**
+     * @brief The highest height that may have active stations.
+     */
+    int highest;
+
+    /**
+     * @brief Sets the height of every station to its distance to the final station in the residual graph (BFS).
+     *
+     * @note Complexity time: O(V+E).
+     *
+     * @param graph The snapshot.
+     * @param t The id of the final station.
+     */
+    void globalRelabel(const CSRGraph& graph, int t);
+
+    /**
+     * @brief Marks a station as active.
+     *
+     * @note Complexity time: O(1).
+     *
+     * @param v The id of the station.
+     */
+    void activate(int v);
+
+    /**
+     * @brief Pushes the excess of a station to its neighbours, relabeling it when needed.
+     *
+     * @note Complexity time: O(V + deg(v)) per relabel.
+     *
+     * @param graph The snapshot.
+     * @param v The id of the station.
+     * @param t The id of the final station.
+     * @return The number of relabels.
+     */
+    int discharge(const CSRGraph& graph, int v, int t);
+
+public:
+    using MaxFlowEngine::maxFlow;
+
+    /**
+     * @brief Gets the maximum number of trains that can simultaneously arrive at a station from a set of stations.
+     *
+     * @note Complexity time: O(V^2 sqrt(E)).
+     *
+     * @param graph The snapshot.
+     * @param sources The ids of the origin stations.
+     * @param t The id of the final station.
+     * @return The maximum flow between the origin stations and the final station.
+     */
+    double maxFlow(const CSRGraph& graph, const std::vector<int>& sources, int t) override;
+};
+
+#endif //DA_PROJ1_MAXFLOWENGINE_H
@@ -0,0 +1,199 @@
+#ifndef DA_PROJ1_NETWORKGENERATOR_H
+#define DA_PROJ1_NETWORKGENERATOR_H
+
+#include <string>
+#include <vector>
+
+#include "StationEdge.h"
+
+class Graph;
+class NetworkGenerator;
+
+/**
+ * @brief The shape of a synthetic network.
+ */
+enum Topology {
+    /**
+     * @brief Trunk lines with branches, each one starting at a station of an older line (a tree, like the dataset).
+     */
+    TOPOLOGY_TREE,
+
+    /**
+     * @brief The tree plus lines between nearby stations of different lines.
+     */
+    TOPOLOGY_MESH,
+
+    /**
+     * @brief The tree with every line bent into a loop that closes on its first station (ring corridors).
+     */
+    TOPOLOGY_RING
+};
+
+/**
+ * @brief How the capacities of the lines are drawn from their range.
+ */
+enum CapacityDistribution {
+    /**
+     * @brief Every capacity of the range is equally likely.
+     */
+    CAPACITY_UNIFORM,
+
+    /**
+     * @brief Each capacity is half as likely as the previous one, so most lines have the lowest capacity (like the dataset).
+     */
+    CAPACITY_GEOMETRIC
+};
+
+/**
+ * @brief Parses the name of a topology ("tree", "mesh" or "ring").
+ *
+ * @param name The name.
+ * @param topology The topology. Initialized only if the name is valid.
+ * @return True if the name is valid.
+ */
+bool parseTopology(const std::string& name, Topology& topology);
+
+/**
+ * @brief Parses the name of a capacity distribution ("uniform" or "geometric").
+ *
+ * @param name The name.
+ * @param distribution The distribution. Initialized only if the name is valid.
+ * @return True if the name is valid.
+ */
+bool parseCapacityDistribution(const std::string& name, CapacityDistribution& distribution);
+
+/**
+ * @brief The parameters of a synthetic network. The defaults give a network like the dataset.
+ */
+struct GeneratorOptions {
+    int numStations = 1000;
+
+    /**
+     * @brief The number of districts, 0 for one per 26 stations (like the dataset).
+     */
+    int numDistricts = 0;
+
+    int municipalitiesPerDistrict = 7;
+
+    /**
+     * @brief The mean number of stations of a line (the line of the stations file).
+     */
+    double meanLineLength = 8;
+
+    Topology topology = TOPOLOGY_TREE;
+
+    /**
+     * @brief The number of extra lines per station of TOPOLOGY_MESH.
+     */
+    double meshRatio = 0.25;
+
+    /**
+     * @brief The fraction of lines whose segments are ALFA PENDULAR.
+     */
+    double alfaPendularRatio = 0.05;
+
+    int minCapacity = 2;
+    int maxCapacity = 10;
+    int capacityStep = 2;
+    CapacityDistribution capacityDistribution = CAPACITY_GEOMETRIC;
+
+    unsigned seed = 1;
+};
+
+/**
+ * @brief Generates a synthetic rail network, deterministic by seed (with any standard library), in the schema of the dataset.
+ *
+ * The lines are laid one at a time: the first starts at the origin and each other one branches from a random station
+ * already laid, walking in a random direction. Consecutive stations of a line are linked by a segment (a row of the
+ * network file) with the service and capacity of the line. The stations are then split in districts, and each district
+ * in municipalities, by their position, so every region is a compact part of the network.
+ */
+class NetworkGenerator {
+public:
+    /**
+     * @brief A row of the stations file.
+     */
+    struct StationRow {
+        std::string name;
+        std::string district;
+        std::string municipality;
+        std::string township;
+        std::string line;
+    };
+
+    /**
+     * @brief A row of the network file, with the indices of the stations.
+     */
+    struct SegmentRow {
+        int origin;
+        int dest;
+        int capacity;
+        ServiceMask service;
+    };
+
+private:
+    std::vector<StationRow> stations;
+    std::vector<SegmentRow> segments;
+
+    /**
+     * @brief The position of each station.
+     */
+    std::vector<std::pair<double, double>> positions;
+
+    /**
+     * @brief The number of the line of each station.
+     */
+    std::vector<int> lineIds;
+
+    /**
+     * @brief Lays the lines and links their consecutive stations.
+     */
+    void layLines(const GeneratorOptions& options);
+
+    /**
+     * @brief Links nearby stations of different lines (TOPOLOGY_MESH).
+     */
+    void addMeshSegments(const GeneratorOptions& options);
+
+    /**
+     * @brief Names the districts, municipalities and townships of the stations.
+     */
+    void assignRegions(const GeneratorOptions& options);
+
+public:
+    /**
+     * @brief Generates a network.
+     *
+     * @note Complexity time: O(V log V + E).
+     *
+     * @param options The parameters of the network. Invalid values are clamped (at least 2 stations, 1 district, ...).
+     */
+    explicit NetworkGenerator(const GeneratorOptions& options);
+
+    const std::vector<StationRow>& getStations() const;
+
+    const std::vector<SegmentRow>& getSegments() const;
+
+    /**
+     * @brief Writes the stations and network files (STATIONS_FILE_NAME and NETWORK_FILE_NAME) into a directory,
+     * creating the directory if needed.
+     *
+     * @note Complexity time: O(V + E).
+     *
+     * @param directory The directory.
+     * @return True if both files were written.
+     * @return False otherwise.
+     */
+    bool write(const std::string& directory) const;
+
+    /**
+     * @brief Adds the stations and lines to a graph, like readStations and readNetwork would after write.
+     *
+     * @note Complexity time: O(V + E).
+     *
+     * @param graph The graph.
+     */
+    void fill(Graph& graph) const;
+};
+
+#endif //DA_PROJ1_NETWORKGENERATOR_H
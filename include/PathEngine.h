@@ -0,0 +1,210 @@
+#ifndef DA_PROJ1_PATHENGINE_H
+#define DA_PROJ1_PATHENGINE_H
+
+#include <vector>
+
+#include "CSRGraph.h"
+
+class PathEngine;
+
+/**
+ * @brief Answers point-to-point minimal cost path queries on a snapshot of the network.
+ *
+ * Each query runs a bidirectional Dijkstra: one search leaves the origin station, another arrives at the destination
+ * station through the reverse lines, and both stop as soon as no shorter path can be found, so only the stations
+ * around both ends are visited. Stations only enter the priority queues when they are reached, and the state of the
+ * searches is reused between queries (with a stamp per query), so a query never pays for the whole network.
+ *
+ * Optionally, the distances to and from a few landmark stations are precomputed (ALT). The triangle inequality then
+ * gives a lower bound of the distance of each station to both ends, which guides both searches towards each other.
+ *
+ * @note The cost of a line is its capacity, as in the original Dijkstra of the project. When every capacity is an
+ * integer, the searches without landmarks use a RadixHeap instead of the binary heap (the potentials of the landmarks
+ * are halves and can be negative, so those searches keep the binary heap).
+ */
+class PathEngine {
+    /**
+     * @brief A node of the priority queues.
+     */
+    struct QueueNode {
+        int id;
+        double key;
+        int queueIndex;
+        bool operator<(QueueNode& node) const { return key < node.key; }
+    };
+
+    /**
+     * @brief The state of one of the two searches.
+     */
+    struct Search {
+        /**
+         * @brief The node of each station in the priority queue.
+         */
+        std::vector<QueueNode> nodes;
+
+        /**
+         * @brief The distance of each station to the end of this search. Valid when reached == stamp.
+         */
+        std::vector<double> distance;
+
+        /**
+         * @brief The line used to reach each station, always in the direction of the network.
+         */
+        std::vector<int> line;
+
+        /**
+         * @brief The query where each station was reached.
+         */
+        std::vector<unsigned> reached;
+
+        /**
+         * @brief The query where each station was settled.
+         */
+        std::vector<unsigned> settled;
+    };
+
+    /**
+     * @brief The snapshot of the network.
+     */
+    const CSRGraph* graph;
+
+    /**
+     * @brief The search that leaves the origin station.
+     */
+    Search forward;
+
+    /**
+     * @brief The search that arrives at the destination station.
+     */
+    Search backward;
+
+    /**
+     * @brief The current query. Every per-station state with another stamp is considered empty.
+     */
+    unsigned stamp = 0;
+
+    /**
+     * @brief The distance from each landmark to every station.
+     */
+    std::vector<std::vector<double>> fromLandmark;
+
+    /**
+     * @brief The distance from every station to each landmark.
+     */
+    std::vector<std::vector<double>> toLandmark;
+
+    /**
+     * @brief The landmarks whose distances to and from both ends of the current query are known.
+     */
+    std::vector<int> usable;
+
+    /**
+     * @brief If every cost of the snapshot is an integer, so the searches without landmarks can use a RadixHeap.
+     */
+    bool integerCosts;
+
+    /**
+     * @brief The potential of each station in the current query.
+     */
+    std::vector<double> potential;
+
+    /**
+     * @brief The query where the potential of each station was computed.
+     */
+    std::vector<unsigned> potentialStamp;
+
+    /**
+     * @brief Computes the distance between a station and every other station, using every line of the network.
+     *
+     * @note Complexity time: O(ElogV).
+     *
+     * @param s The id of the station.
+     * @param reverse If true, the distances from every station to s are computed instead.
+     * @param distance The distances, infinite for the stations that can not be reached. Must be initialized in this function.
+     */
+    void distancesFrom(int s, bool reverse, std::vector<double>& distance) const;
+
+    /**
+     * @brief Computes the distances of distancesFrom with the given priority queue.
+     *
+     * @note Complexity time: O(ElogV).
+     *
+     * @tparam Queue MutablePriorityQueue or, if the costs are integers, RadixHeap.
+     * @param s The id of the station.
+     * @param reverse If true, the distances from every station to s are computed instead.
+     * @param distance The distances, infinite for the stations that can not be reached. Must be initialized in this function.
+     */
+    template <class Queue>
+    void distancesWith(int s, bool reverse, std::vector<double>& distance) const;
+
+    /**
+     * @brief Runs the bidirectional search of shortestPath with the given priority queue, after the query was prepared.
+     *
+     * @note Complexity time: O(ElogV) in the worst case, usually a small part of the network.
+     *
+     * @tparam Queue MutablePriorityQueue or, if the costs are integers and there are no landmarks, RadixHeap.
+     * @param s The id of the origin station.
+     * @param t The id of the destination station.
+     * @param services The services that the path can use.
+     * @param lines The lines of the path, from the origin to the destination station.
+     * @return True if a path exists.
+     * @return False otherwise.
+     */
+    template <class Queue>
+    bool searchWith(int s, int t, ServiceMask services, std::vector<int>& lines);
+
+    /**
+     * @brief Gets the potential of a station: half of the difference between the lower bounds of its distance to the
+     * destination and from the origin, which keeps the reduced cost of every line non-negative in both searches.
+     *
+     * @note Complexity time: O(L), L being the number of landmarks.
+     *
+     * @param v The id of the station.
+     * @param s The id of the origin station.
+     * @param t The id of the destination station.
+     * @return The potential, infinite if the station can not be in a path between both stations.
+     */
+    double getPotential(int v, int s, int t);
+
+public:
+    /**
+     * @brief Creates an engine for a snapshot, without landmarks.
+     *
+     * @note Complexity time: O(V).
+     *
+     * @param graph The snapshot. Must outlive the engine.
+     */
+    explicit PathEngine(const CSRGraph& graph);
+
+    /**
+     * @brief Chooses landmarks (each one the farthest station from the ones already chosen) and computes their distances.
+     *
+     * @note Complexity time: O(k ElogV).
+     *
+     * @param k The number of landmarks. 0 disables the heuristic.
+     */
+    void buildLandmarks(int k);
+
+    /**
+     * @brief Gets the number of landmarks.
+     *
+     * @return The number of landmarks.
+     */
+    int getNumLandmarks() const;
+
+    /**
+     * @brief Finds the minimal cost path between two stations using only the lines of the given services.
+     *
+     * @note Complexity time: O(ElogV) in the worst case, usually a small part of the network.
+     *
+     * @param s The id of the origin station.
+     * @param t The id of the destination station.
+     * @param services The services that the path can use.
+     * @param lines The lines of the path, from the origin to the destination station. Must be initialized in this function.
+     * @return True if a path exists.
+     * @return False otherwise.
+     */
+    bool shortestPath(int s, int t, ServiceMask services, std::vector<int>& lines);
+};
+
+#endif //DA_PROJ1_PATHENGINE_H
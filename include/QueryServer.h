@@ -0,0 +1,183 @@
+#ifndef DA_PROJ1_QUERYSERVER_H
+#define DA_PROJ1_QUERYSERVER_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <istream>
+#include <ostream>
+
+#include "Graph.h"
+#include "BatchRunner.h"
+
+class QueryServer;
+
+/**
+ * @brief Keeps the network loaded and answers queries sent through a local socket (see SocketIO.h).
+ *
+ * Each request is a frame with one query in the syntax of BatchRunner (e.g. "maxflow,Porto Campanhã,Lisboa Oriente")
+ * and each answer is a frame with its result as a JSON object, where "line" is the number of the request in the
+ * connection. A client can send many requests through the same connection.
+ *
+ * The open connections are watched by run, and a worker only takes a connection while it has requests to answer, so
+ * idle clients do not hold workers. A client that stops in the middle of a frame is disconnected after a few seconds.
+ *
+ * The clients are served by a fixed number of workers that share one graph, loaded once from the binary dataset and the
+ * route index. Each worker only has its own query state (see QueryContext): the max flow engine, the searches and the
+ * flow of the what-if queries, O(V + E) per worker. The graph is never modified, so every answer is computed on the
+ * same network, and a client waits only for its own queries.
+ */
+class QueryServer {
+    /**
+     * @brief An open connection.
+     */
+    struct Connection {
+        int socket;
+
+        /**
+         * @brief The number of requests answered, the "line" of the last answer.
+         */
+        int requests;
+    };
+
+    /**
+     * @brief The graph shared by the workers.
+     */
+    Graph graph;
+
+    /**
+     * @brief The runner of the queries of each worker, with the query state of the worker.
+     */
+    std::vector<std::unique_ptr<BatchRunner>> runners;
+
+    /**
+     * @brief The threads of the workers.
+     */
+    std::vector<std::thread> workers;
+
+    std::mutex mutex;
+    std::condition_variable wake;
+
+    /**
+     * @brief The connections with requests to answer.
+     */
+    std::deque<Connection> pending;
+
+    /**
+     * @brief The connections without requests, watched by run. Only used by the thread of run.
+     */
+    std::vector<Connection> idle;
+
+    /**
+     * @brief The connections the workers stopped answering, given back to run.
+     */
+    std::vector<Connection> returned;
+
+    /**
+     * @brief A pipe that wakes run when a connection is given back.
+     */
+    int wakePipe[2] = {-1, -1};
+
+    /**
+     * @brief The connection each worker is serving, -1 if none.
+     */
+    std::vector<int> active;
+
+    /**
+     * @brief The socket that accepts the connections.
+     */
+    int listener = -1;
+
+    /**
+     * @brief The address of the listener.
+     */
+    std::string address;
+
+    bool stopping = false;
+
+    /**
+     * @brief Answers the connections with requests until the server stops, giving each one back to run afterwards.
+     *
+     * @param worker The index of the worker.
+     */
+    void workerLoop(int worker);
+
+    /**
+     * @brief Answers the requests of a connection while it has requests ready, up to a few per turn so the other
+     * connections are not starved.
+     *
+     * @param client The connection.
+     * @param runner The runner of the worker.
+     * @return True if the connection is still open.
+     * @return False if it was closed, failed or timed out.
+     */
+    static bool serve(Connection& client, BatchRunner& runner);
+
+public:
+    /**
+     * @brief Loads the network once and starts the workers.
+     *
+     * @note Complexity time: O(V + E). The binary dataset and the route index are used only if they were built (see
+     * Graph::saveBinaryDataset and Graph::buildRouteIndex).
+     *
+     * @param algorithm The max flow algorithm.
+     * @param numWorkers The number of clients served at the same time.
+     * @param datasetDirectory The directory of the dataset (see Graph::setDatasetDirectory).
+     */
+    QueryServer(MaxFlowAlgorithm algorithm, unsigned numWorkers, const std::string& datasetDirectory = DATASET_DIRECTORY);
+
+    /**
+     * @brief Stops the server.
+     */
+    ~QueryServer();
+
+    QueryServer(const QueryServer&) = delete;
+    QueryServer& operator=(const QueryServer&) = delete;
+
+    /**
+     * @brief Sees if the network was loaded.
+     *
+     * @return True if the network has stations.
+     */
+    bool isLoaded() const;
+
+    /**
+     * @brief Opens the socket of the server.
+     *
+     * @param address The address, "unix:<path>" or "tcp:<port>".
+     * @return True if the socket was opened.
+     * @return False otherwise.
+     */
+    bool listen(const std::string& address);
+
+    /**
+     * @brief Accepts connections and hands the ones with requests to the workers until the process receives SIGINT or
+     * SIGTERM, then stops the workers.
+     */
+    void run();
+
+    /**
+     * @brief Stops accepting connections, closes the open ones and waits for the workers.
+     *
+     * @note Called by run when it returns, or by the destructor.
+     */
+    void stop();
+};
+
+/**
+ * @brief Sends each line of the input to a server as one request and writes each answer in its own line (a client to
+ * test the server). The number of requests and their latency are written to the standard error.
+ *
+ * @param address The address of the server.
+ * @param in The requests, one per line.
+ * @param out The answers.
+ * @return True if every request was answered.
+ * @return False if the connection failed.
+ */
+bool runQueryClient(const std::string& address, std::istream& in, std::ostream& out);
+
+#endif //DA_PROJ1_QUERYSERVER_H
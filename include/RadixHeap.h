@@ -0,0 +1,174 @@
+#ifndef DA_PROJ1_RADIXHEAP_H
+#define DA_PROJ1_RADIXHEAP_H
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+
+/**
+ * class T must have: (i) accessible field int queueIndex; (ii) accessible field key, a non-negative integer value.
+ */
+
+/**
+ * @brief A monotone priority queue for integer keys (radix heap), with the same interface as MutablePriorityQueue.
+ *
+ * The elements are kept in buckets by the highest bit where their key differs from the last extracted key, so an
+ * insertion is O(1) and each element moves down at most 64 buckets in total. There are no comparisons through
+ * pointers and no sift-up or sift-down, which makes it cheaper than a binary heap for Dijkstra with integer costs.
+ * A decreased key is inserted again, and the outdated entry is skipped when found.
+ *
+ * @note The keys must never be smaller than the key of the last extracted element (true in Dijkstra with non-negative costs).
+ * @tparam T A class for the template.
+ */
+template <class T>
+class RadixHeap {
+    /**
+     * @brief One bucket for the keys equal to the last extracted key and one per bit of the key.
+     */
+    static const int NUM_BUCKETS = 65;
+
+    /**
+     * @brief The entries (key when inserted, element) of each bucket.
+     */
+    std::vector<std::pair<std::uint64_t, T*>> buckets[NUM_BUCKETS];
+
+    /**
+     * @brief The entries of the bucket being spread, kept to reuse its memory.
+     */
+    std::vector<std::pair<std::uint64_t, T*>> spread;
+
+    /**
+     * @brief The key of the last extracted element.
+     */
+    std::uint64_t last = 0;
+
+    /**
+     * @brief The number of elements in the queue, not counting the outdated entries.
+     */
+    std::size_t count = 0;
+
+    /**
+     * @brief Gets the bucket of a key: 0 if it is equal to the last extracted key, 1 + the highest bit where they differ otherwise.
+     *
+     * @param key The key.
+     * @return The bucket.
+     */
+    int bucketOf(std::uint64_t key) const;
+
+    /**
+     * @brief Sees if an entry still stands for its element (the element is in the queue and its key did not change).
+     *
+     * @param entry The entry.
+     * @return True if the entry is up to date.
+     */
+    static bool isCurrent(const std::pair<std::uint64_t, T*>& entry);
+
+public:
+    /**
+     * @brief Creates an empty queue.
+     */
+    RadixHeap();
+
+    /**
+     * @brief Insert an element in the queue.
+     *
+     * @param x The element that will be inserted.
+     */
+    void insert(T * x);
+
+    /**
+     * @brief Extracts the minimal element of the queue.
+     *
+     * @return The minimal element.
+     */
+    T * extractMin();
+
+    /**
+     * @brief Updates the position of an element whose key was decreased.
+     *
+     * @param x The element that will be updated.
+     */
+    void decreaseKey(T * x);
+
+    /**
+     * @brief Returns if the queue is empty.
+     *
+     * @return True if the queue is empty.
+     */
+    bool empty();
+};
+
+template <class T>
+RadixHeap<T>::RadixHeap() = default;
+
+template <class T>
+int RadixHeap<T>::bucketOf(std::uint64_t key) const {
+    std::uint64_t diff = key ^ last;
+    if (diff == 0) return 0;
+#if defined(__GNUC__)
+    return 64 - __builtin_clzll(diff);
+#else
+    int bit = 0;
+    while (diff != 0) {
+        diff >>= 1;
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+template <class T>
+bool RadixHeap<T>::isCurrent(const std::pair<std::uint64_t, T*>& entry) {
+    return entry.second->queueIndex != 0 && (std::uint64_t) entry.second->key == entry.first;
+}
+
+template <class T>
+bool RadixHeap<T>::empty() {
+    return count == 0;
+}
+
+template <class T>
+void RadixHeap<T>::insert(T *x) {
+    std::uint64_t key = (std::uint64_t) x->key;
+    x->queueIndex = 1;
+    buckets[bucketOf(key)].emplace_back(key, x);
+    count++;
+}
+
+template <class T>
+void RadixHeap<T>::decreaseKey(T *x) {
+    std::uint64_t key = (std::uint64_t) x->key;
+    buckets[bucketOf(key)].emplace_back(key, x);
+}
+
+template <class T>
+T* RadixHeap<T>::extractMin() {
+    while (true) {
+        while (!buckets[0].empty()) {
+            auto entry = buckets[0].back();
+            buckets[0].pop_back();
+            if (!isCurrent(entry)) continue;
+            entry.second->queueIndex = 0;
+            count--;
+            return entry.second;
+        }
+
+        // the first non-empty bucket has the minimum; its entries are spread by the new last key
+        int i = 1;
+        while (buckets[i].empty()) i++;
+        spread.swap(buckets[i]);
+
+        bool found = false;
+        for (auto& entry : spread) {
+            if (!isCurrent(entry)) continue;
+            if (!found || entry.first < last) last = entry.first;
+            found = true;
+        }
+        for (auto& entry : spread) {
+            if (isCurrent(entry)) buckets[bucketOf(entry.first)].push_back(entry);
+        }
+        spread.clear();
+    }
+}
+
+#endif //DA_PROJ1_RADIXHEAP_H
@@ -0,0 +1,203 @@
+#ifndef DA_PROJ1_RESULTCACHE_H
+#define DA_PROJ1_RESULTCACHE_H
+
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+#include "StationEdge.h"
+
+/**
+ * @brief The number of entries of each result cache of a Graph by default.
+ */
+const std::size_t DEFAULT_CACHE_CAPACITY = 4096;
+
+/**
+ * @brief The hits and misses of the result caches.
+ */
+struct CacheStats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::size_t entries = 0;
+
+    /**
+     * @brief Gets the fraction of the lookups that were hits.
+     *
+     * @return The hit rate, 0 if there were no lookups.
+     */
+    double hitRate() const { return hits + misses == 0 ? 0 : (double) hits / (double) (hits + misses); }
+};
+
+/**
+ * @brief The key of a cached result: a pair of stations of a snapshot, the services used and the topology version of
+ * the graph when the result was computed.
+ */
+struct CacheKey {
+    int source;
+    int target;
+    ServiceMask service;
+    std::uint64_t version;
+
+    bool operator==(const CacheKey& key) const {
+        return source == key.source && target == key.target && service == key.service && version == key.version;
+    }
+};
+
+/**
+ * @brief A least recently used cache of query results, split in shards with their own lock so parallel workers rarely wait.
+ *
+ * Since the key has the topology version, a result computed before the graph changed is never returned; it is simply
+ * evicted when its shard is full.
+ *
+ * @tparam Value The type of the results.
+ */
+template <class Value>
+class ResultCache {
+    struct KeyHash {
+        std::size_t operator()(const CacheKey& key) const {
+            std::uint64_t hash = (std::uint64_t) (unsigned) key.source * 0x9E3779B97F4A7C15ULL;
+            hash ^= ((std::uint64_t) (unsigned) key.target << 8 | key.service) + 0x7F4A7C15 + (hash << 6) + (hash >> 2);
+            hash ^= key.version + 0x9E3779B9 + (hash << 6) + (hash >> 2);
+            return (std::size_t) hash;
+        }
+    };
+
+    /**
+     * @brief A part of the cache: the entries from the most to the least recently used, and an index of them.
+     */
+    struct Shard {
+        std::mutex mutex;
+        std::list<std::pair<CacheKey, Value>> entries;
+        std::unordered_map<CacheKey, typename std::list<std::pair<CacheKey, Value>>::iterator, KeyHash> index;
+    };
+
+    static const int NUM_SHARDS = 16;
+
+    Shard shards[NUM_SHARDS];
+
+    /**
+     * @brief The number of entries of each shard.
+     */
+    std::size_t shardCapacity;
+
+    std::atomic<std::uint64_t> hits{0};
+    std::atomic<std::uint64_t> misses{0};
+
+    /**
+     * @brief Gets the shard of a key.
+     */
+    Shard& shardOf(const CacheKey& key) { return shards[KeyHash()(key) % NUM_SHARDS]; }
+
+public:
+    /**
+     * @brief Creates an empty cache.
+     *
+     * @param capacity The number of entries. 0 disables the cache.
+     */
+    explicit ResultCache(std::size_t capacity = DEFAULT_CACHE_CAPACITY);
+
+    /**
+     * @brief Looks for a result, marking it as the most recently used.
+     *
+     * @note Complexity time: O(1) on average.
+     *
+     * @param key The key.
+     * @param value The result. Initialized only if it was found.
+     * @return True if the result was found.
+     * @return False otherwise.
+     */
+    bool find(const CacheKey& key, Value& value);
+
+    /**
+     * @brief Stores a result, evicting the least recently used result of its shard if the shard is full.
+     *
+     * @note Complexity time: O(1) on average.
+     *
+     * @param key The key.
+     * @param value The result.
+     */
+    void insert(const CacheKey& key, const Value& value);
+
+    /**
+     * @brief Changes the number of entries, removing every result.
+     *
+     * @param capacity The number of entries. 0 disables the cache.
+     */
+    void setCapacity(std::size_t capacity);
+
+    /**
+     * @brief Gets the hits, misses and number of entries of the cache.
+     *
+     * @note Complexity time: O(1).
+     *
+     * @return The statistics.
+     */
+    CacheStats getStats();
+};
+
+template <class Value>
+ResultCache<Value>::ResultCache(std::size_t capacity) {
+    shardCapacity = (capacity + NUM_SHARDS - 1) / NUM_SHARDS;
+}
+
+template <class Value>
+bool ResultCache<Value>::find(const CacheKey &key, Value &value) {
+    if (shardCapacity == 0) return false;
+    Shard& shard = shardOf(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it == shard.index.end()) {
+        misses++;
+        return false;
+    }
+    shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+    value = it->second->second;
+    hits++;
+    return true;
+}
+
+template <class Value>
+void ResultCache<Value>::insert(const CacheKey &key, const Value &value) {
+    if (shardCapacity == 0) return;
+    Shard& shard = shardOf(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    auto it = shard.index.find(key);
+    if (it != shard.index.end()) {
+        it->second->second = value;
+        shard.entries.splice(shard.entries.begin(), shard.entries, it->second);
+        return;
+    }
+    if (shard.entries.size() >= shardCapacity) {
+        shard.index.erase(shard.entries.back().first);
+        shard.entries.pop_back();
+    }
+    shard.entries.emplace_front(key, value);
+    shard.index[key] = shard.entries.begin();
+}
+
+template <class Value>
+void ResultCache<Value>::setCapacity(std::size_t capacity) {
+    for (Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        shard.entries.clear();
+        shard.index.clear();
+    }
+    shardCapacity = (capacity + NUM_SHARDS - 1) / NUM_SHARDS;
+}
+
+template <class Value>
+CacheStats ResultCache<Value>::getStats() {
+    CacheStats stats;
+    stats.hits = hits;
+    stats.misses = misses;
+    for (Shard& shard : shards) {
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        stats.entries += shard.entries.size();
+    }
+    return stats;
+}
+
+#endif //DA_PROJ1_RESULTCACHE_H
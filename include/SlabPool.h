@@ -0,0 +1,126 @@
+#ifndef DA_PROJ1_SLABPOOL_H
+#define DA_PROJ1_SLABPOOL_H
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <cstddef>
+
+/**
+ * @brief Allocates objects of one type in contiguous blocks, reusing the slots of the destroyed objects.
+ *
+ * Objects created one after the other end up next to each other in memory, so walking them (e.g. the lines of the
+ * network) touches few cache lines. An object never moves, so pointers to it stay valid until it is destroyed, and the
+ * memory of every block is released at once when the pool is destroyed.
+ *
+ * @note The pool does not know which objects are still alive: the owner must destroy them before destroying the pool.
+ * @tparam T The type of the objects.
+ */
+template <class T>
+class SlabPool {
+    /**
+     * @brief Uninitialized memory for one object.
+     */
+    struct Slot {
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    /**
+     * @brief The number of objects in each block.
+     */
+    static const std::size_t BLOCK_SIZE = 1024;
+
+    /**
+     * @brief The blocks of memory. Only the last one may have slots that were never used.
+     */
+    std::vector<std::unique_ptr<Slot[]>> blocks;
+
+    /**
+     * @brief The number of slots of the last block that were already used.
+     */
+    std::size_t used = BLOCK_SIZE;
+
+    /**
+     * @brief The slots of the destroyed objects, reused before any new slot.
+     */
+    std::vector<Slot*> freeSlots;
+
+    /**
+     * @brief The number of objects alive.
+     */
+    std::size_t alive = 0;
+
+public:
+    /**
+     * @brief Creates an empty pool. No memory is allocated until the first object is created.
+     */
+    SlabPool() = default;
+
+    SlabPool(const SlabPool&) = delete;
+
+    SlabPool& operator=(const SlabPool&) = delete;
+
+    /**
+     * @brief Creates an object in the pool.
+     *
+     * @note Complexity time: O(1) amortized.
+     *
+     * @param args The arguments of the constructor of the object.
+     * @return The object.
+     */
+    template <class... Args>
+    T* create(Args&&... args);
+
+    /**
+     * @brief Destroys an object of the pool, leaving its slot to the next object created.
+     *
+     * @note Complexity time: O(1).
+     *
+     * @param object The object, created by this pool.
+     */
+    void destroy(T* object);
+
+    /**
+     * @brief Gets the number of objects alive in the pool.
+     *
+     * @note Complexity time: O(1).
+     *
+     * @return The number of objects.
+     */
+    std::size_t size() const;
+};
+
+template <class T>
+template <class... Args>
+T* SlabPool<T>::create(Args&&... args) {
+    Slot* slot;
+    if (!freeSlots.empty()) {
+        slot = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else {
+        if (used == BLOCK_SIZE) {
+            blocks.emplace_back(new Slot[BLOCK_SIZE]);
+            used = 0;
+        }
+        slot = &blocks.back()[used++];
+    }
+    T* object = new (slot->storage) T(std::forward<Args>(args)...);
+    alive++;
+    return object;
+}
+
+template <class T>
+void SlabPool<T>::destroy(T* object) {
+    if (object == nullptr) return;
+    object->~T();
+    freeSlots.push_back(reinterpret_cast<Slot*>(object));
+    alive--;
+}
+
+template <class T>
+std::size_t SlabPool<T>::size() const {
+    return alive;
+}
+
+#endif //DA_PROJ1_SLABPOOL_H
@@ -0,0 +1,81 @@
+#ifndef DA_PROJ1_SOCKETIO_H
+#define DA_PROJ1_SOCKETIO_H
+
+#include <string>
+#include <cstdint>
+
+/**
+ * @brief The largest payload accepted in a frame. Larger frames close the connection.
+ */
+const std::uint32_t MAX_FRAME_SIZE = 1 << 20;
+
+/**
+ * @brief Opens a socket that accepts connections.
+ *
+ * @note The address is "unix:<path>" for a Unix domain socket (a socket left at the path is replaced, any other file
+ * makes it fail) or "tcp:<port>" for a TCP socket on the loopback interface only.
+ *
+ * @param address The address.
+ * @return The socket, -1 if the address is not valid or can not be used.
+ */
+int listenOn(const std::string& address);
+
+/**
+ * @brief Removes the file of a Unix domain socket. Anything at the path that is not a socket is left alone.
+ *
+ * @param path The path of the socket.
+ * @return True if the path is free (the socket was removed or nothing was there).
+ * @return False otherwise.
+ */
+bool removeSocketFile(const std::string& path);
+
+/**
+ * @brief Connects to a socket opened with listenOn.
+ *
+ * @param address The address, in the format of listenOn.
+ * @return The socket, -1 if the connection failed.
+ */
+int connectTo(const std::string& address);
+
+/**
+ * @brief Limits how long a read or a write on a socket may wait for the other end.
+ *
+ * @param socket The socket.
+ * @param milliseconds The limit. A read or write that waits longer fails (see readFrame and writeFrame).
+ * @return True if the limit was set.
+ * @return False otherwise.
+ */
+bool setTimeout(int socket, int milliseconds);
+
+/**
+ * @brief Reads a frame: the size of the payload (4 bytes, big-endian) followed by the payload.
+ *
+ * @note Complexity time: O(n), n being the size of the payload.
+ *
+ * @param socket The socket.
+ * @param payload The payload. Must be initialized in this function.
+ * @return True if a whole frame was read.
+ * @return False if the connection was closed, failed, timed out (see setTimeout) or sent a frame larger than MAX_FRAME_SIZE.
+ */
+bool readFrame(int socket, std::string& payload);
+
+/**
+ * @brief Writes a frame (see readFrame) with a single system call when possible.
+ *
+ * @note Complexity time: O(n), n being the size of the payload.
+ *
+ * @param socket The socket.
+ * @param payload The payload.
+ * @return True if the whole frame was written.
+ * @return False otherwise.
+ */
+bool writeFrame(int socket, const std::string& payload);
+
+/**
+ * @brief Closes a socket.
+ *
+ * @param socket The socket.
+ */
+void closeSocket(int socket);
+
+#endif //DA_PROJ1_SOCKETIO_H
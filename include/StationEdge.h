@@ -6,10 +6,58 @@
 #define DA_PROJ1_STATIONEDGE_H
 
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "SymbolTable.h"
+#include "SlabPool.h"
+
 class Edge;
 
+/************************* Service  **************************/
+
+/**
+ * @brief A bitmask of services. Each line provides exactly one service, so a traversal can filter the lines it uses with a single AND.
+ *
+ * @note To add a new service, add a new bit below and its name to parseService.
+ */
+typedef unsigned char ServiceMask;
+
+/**
+ * @brief The service of a residual line that is not part of the railway network.
+ */
+const ServiceMask SERVICE_NONE = 0;
+
+/**
+ * @brief The STANDARD service.
+ */
+const ServiceMask SERVICE_STANDARD = 1;
+
+/**
+ * @brief The ALFA PENDULAR service.
+ */
+const ServiceMask SERVICE_ALFA_PENDULAR = 2;
+
+/**
+ * @brief Any other service (e.g. the lines that connect the super source to the network).
+ */
+const ServiceMask SERVICE_OTHER = 4;
+
+/**
+ * @brief Every service of the railway network.
+ */
+const ServiceMask SERVICE_ALL = 0xFF;
+
+/**
+ * @brief Gets the service that corresponds to the name of a service, ignoring trailing whitespace.
+ *
+ * @note Complexity time: O(1).
+ *
+ * @param service The name of the service, which can be either STANDARD or ALFA PENDULAR.
+ * @return The corresponding service. SERVICE_OTHER if the name is unknown.
+ */
+ServiceMask parseService(std::string_view service);
+
 /************************* Station  **************************/
 
 /**
@@ -23,24 +71,24 @@ private:
     std::string name;
 
     /**
-     * @brief The district where the station belongs.
+     * @brief The district where the station belongs, interned in the global symbol table.
      */
-    std::string district;
+    Symbol district;
 
     /**
-     * @brief The municipality where the station belongs.
+     * @brief The municipality where the station belongs, interned in the global symbol table.
      */
-    std::string municipality;
+    Symbol municipality;
 
     /**
-     * @brief The township where the station belongs.
+     * @brief The township where the station belongs, interned in the global symbol table.
      */
-    std::string township;
+    Symbol township;
 
     /**
-     * @brief The main line where the station serves.
+     * @brief The main line where the station serves, interned in the global symbol table.
      */
-    std::string line;
+    Symbol line;
 
     /**
      * @brief A vector with the outgoing edges.
@@ -53,33 +101,39 @@ private:
     std::vector<Edge*> incoming;
 
     /**
-     * @brief A visited attribute. Used for maxFlow and DFS.
+     * @brief The id of this station in the last CSRGraph snapshot of the graph.
      */
-    bool visited;
+    int id;
 
     /**
-     * @brief A path that contains the edge taken to get to this station. Used for maxFlow.
+     * @brief The pool of the graph where the lines of this station are allocated.
      */
-    Edge* path;
+    SlabPool<Edge>* edgePool;
 
     /**
-     * @brief The cost that takes to get from a station to this station. Need for Dijkstra.
+     * @brief Removes an edge that leaves this station from the outgoing edges of this station and the incoming edges of
+     * its destination, swapping the last edge of each list into its position.
+     *
+     * @note Complexity time: O(1).
+     *
+     * @param edge The edge.
      */
-    double cost;
+    void unlinkEdge(Edge* edge);
 
 public:
     /**
      * @brief A constructor that initializes a station with a name, district, municipality, township and line.
      *
-     * @note This constructor initializes path as nullptr, visited as false and cost as 0.
+     * @note This constructor initializes the id as -1 and interns every attribute but the name.
      *
      * @param name The name of the station.
      * @param district The district where the station belongs.
      * @param municipality The municipality where the station belongs.
      * @param township The township where the station belongs.
      * @param line The line that the station serves.
+     * @param edgePool The pool where the lines that leave the station are allocated. Must outlive the station.
      */
-    Station(const std::string& name, const std::string& district, const std::string& municipality, const std::string& township, const std::string& line);
+    Station(const std::string& name, const std::string& district, const std::string& municipality, const std::string& township, const std::string& line, SlabPool<Edge>& edgePool);
 
     /**
      * @brief Gets the station name.
@@ -88,7 +142,7 @@ public:
      *
      * @return The station name.
      */
-    std::string getName() const;
+    const std::string& getName() const;
 
     /**
      * @brief Gets the district where the station belongs.
@@ -97,7 +151,7 @@ public:
      *
      * @return The district of the station.
      */
-    std::string getDistrict() const;
+    const std::string& getDistrict() const;
 
     /**
      * @brief Gets the municipality where the station belongs.
@@ -106,7 +160,7 @@ public:
      *
      * @return The municipality of the station.
      */
-    std::string getMunicipality() const;
+    const std::string& getMunicipality() const;
 
     /**
      * @brief Gets the township where the station belongs.
@@ -115,7 +169,7 @@ public:
      *
      * @return The township of the station.
      */
-    std::string getTownShip() const;
+    const std::string& getTownShip() const;
 
     /**
      * @brief Gets the line that serves the station.
@@ -124,148 +178,133 @@ public:
      *
      * @return The line of the station.
      */
-    std::string getLine() const;
+    const std::string& getLine() const;
 
     /**
-     * @brief Gets the outgoing edges of this station.
+     * @brief Gets the id of the district where the station belongs. Stations of the same district have the same id.
      *
      * @note Complexity time: O(1).
      *
-     * @return The outgoing edges.
+     * @return The symbol of the district.
      */
-    std::vector<Edge*> getAdj() const;
+    Symbol getDistrictId() const;
 
     /**
-     * @brief Gets the incoming edges of this station.
+     * @brief Gets the id of the municipality where the station belongs. Stations of the same municipality have the same id.
      *
      * @note Complexity time: O(1).
      *
-     * @return The incoming edges.
+     * @return The symbol of the municipality.
      */
-    std::vector<Edge*> getIncoming() const;
+    Symbol getMunicipalityId() const;
 
     /**
-     * @brief Connects two stations by adding a line (edge).
+     * @brief Gets the id of the township where the station belongs. Stations of the same township have the same id.
      *
      * @note Complexity time: O(1).
      *
-     * @param dest The destination station.
-     * @param capacity The number of trains that can simultaneously travel between this station and the destination station.
-     * @param service The type of service that line provides, which can be either STANDARD or ALFA PENDULAR.
-     * @return The edge if it was successfully created.
-     * @return Null pointer otherwise.
+     * @return The symbol of the township.
      */
-    Edge* addLine(Station* dest, const double capacity, const std::string& service);
+    Symbol getTownShipId() const;
 
     /**
-     * @brief Removes an edge (line) from this station that connects to other station.
-     *
-     * @note Complexity time: O(E^2).
+     * @brief Gets the id of the line that serves the station. Stations of the same line have the same id.
      *
-     * @param name The name of the other station which edge is going to be removed.
-     * @return True if the edge was successfully removed.
-     * @return False otherwise.
-     */
-    bool removeEdge(std::string name);
-
-    /**
-     * @brief Removes all outgoing edges from this station.
+     * @note Complexity time: O(1).
      *
-     * @note Complexity time: O(E^2).
+     * @return The symbol of the line.
      */
-    void removeOutgoingEdges();
+    Symbol getLineId() const;
 
     /**
-     * @brief Removes and stores the edge that leaves this station and arrives the destination station.
+     * @brief Gets the outgoing edges of this station.
      *
-     * @note Complexity time: O(E).
+     * @note Complexity time: O(1).
      *
-     * @param dest The destination station.
-     * @return The Edge if it exists.
-     * @return Null pointer if it does not exist.
+     * @return The outgoing edges.
      */
-    Edge* removeAndStoreEdge(Station* dest);
+    const std::vector<Edge*>& getAdj() const;
 
     /**
-     * @brief Deletes an edge (line) from the destination station.
+     * @brief Gets the incoming edges of this station.
      *
-     * @note Complexity time: O(E).
+     * @note Complexity time: O(1).
      *
-     * @param edge The edge that is going to get deleted.
+     * @return The incoming edges.
      */
-    void deleteEdge(Edge* edge);
+    const std::vector<Edge*>& getIncoming() const;
 
     /**
-     * @brief Set this station as visited or not visited.
+     * @brief Connects two stations by adding a line (edge).
      *
      * @note Complexity time: O(1).
      *
-     * @param The visited attribute.
+     * @param dest The destination station.
+     * @param capacity The number of trains that can simultaneously travel between this station and the destination station.
+     * @param service The type of service that line provides, which can be either STANDARD or ALFA PENDULAR.
+     * @return The edge if it was successfully created.
+     * @return Null pointer otherwise.
      */
-    void setVisited(bool vis);
+    Edge* addLine(Station* dest, const double capacity, ServiceMask service);
 
     /**
-     * @brief Sees if this station is visited.
+     * @brief Removes every edge (line) from this station that connects to other station.
      *
-     * @note Complexity time: O(1).
+     * @note Complexity time: O(deg), deg being the number of outgoing edges of this station.
      *
-     * @return True if this station is visited.
+     * @param name The name of the other station which edge is going to be removed.
+     * @return True if the edge was successfully removed.
      * @return False otherwise.
      */
-    bool isVisited() const;
+    bool removeEdge(const std::string& name);
 
     /**
-     * @brief Sets the path that contains the edge taken to get to this station.
-     *
-     * @note Complexity time: O(1).
+     * @brief Removes all outgoing edges from this station.
      *
-     * @param path The edge taken to get to this station.
+     * @note Complexity time: O(deg), deg being the number of outgoing edges of this station.
      */
-    void setPath(Edge* path);
+    void removeOutgoingEdges();
 
     /**
-     * @brief Gets the path that contains the edge taken to get to this station.
+     * @brief Removes and stores the edge that leaves this station and arrives the destination station.
      *
-     * @note Complexity time: O(1).
+     * @note The edge is unlinked from both stations and from its reverse, and stays allocated in the pool until the graph is destroyed.
+     * @note Complexity time: O(deg), deg being the number of outgoing edges of this station.
      *
-     * @return The edge taken to get to this station.
-     * @return Null pointer if the edge does not exist.
+     * @param dest The destination station.
+     * @return The Edge if it exists.
+     * @return Null pointer if it does not exist.
      */
-    Edge* getPath() const;
+    Edge* removeAndStoreEdge(Station* dest);
 
     /**
-     * @brief Sets the cost that takes to get to this station.
+     * @brief Deletes an edge (line) that leaves this station, unlinking it from both stations, and returns its memory to the pool.
      *
      * @note Complexity time: O(1).
      *
-     * @param cost The cost.
+     * @param edge The edge that is going to get deleted.
      */
-    void setCost(double cost);
+    void deleteEdge(Edge* edge);
+
 
     /**
-     * @brief Gets the cost that takes to get to this station.
+     * @brief Sets the id of this station in a CSRGraph snapshot.
      *
      * @note Complexity time: O(1).
      *
-     * @return The cost.
+     * @param id The id.
      */
-    double getCost() const;
+    void setId(int id);
 
     /**
-     * @brief Compares this station's cost to another station's cost
+     * @brief Gets the id of this station in the last CSRGraph snapshot of the graph.
      *
      * @note Complexity time: O(1).
      *
-     * @param station The another station that we are going to compare.
-     * @return True if this station's cost is fewer than the other station's cost.
-     * @return False if this station's cost is greater than the other station's cost.
+     * @return The id.
      */
-    bool operator<(Station& station) const;
+    int getId() const;
 
-    /**
-     * @brief Index of this station in Priority Queue. Need for Dijkstra.
-     */
-    int queueIndex;
 };
 
 /************************* Edge  **************************/
@@ -293,7 +332,7 @@ private:
     /**
      * @brief The type of service that it provides, which can be either STANDARD or ALFA PENDULAR.
      */
-    std::string service;
+    ServiceMask service;
 
     /**
      * @brief The edge that connects the destination station to this station.
@@ -301,21 +340,32 @@ private:
     Edge* reverse;
 
     /**
-     * @brief The flow that this edge supports. Used for maxFlow.
+     * @brief The position of this edge in the outgoing edges of the origin station, -1 if it was unlinked.
+     */
+    int adjIndex;
+
+    /**
+     * @brief The position of this edge in the incoming edges of the destination station, -1 if it was unlinked.
      */
-    double flow;
+    int incomingIndex;
+
+    /**
+     * @brief The index of this edge when the lines of the graph were last numbered (by the CSRGraph snapshot or writeBinaryDataset).
+     */
+    int id;
+
 public:
     /**
      * @brief Constructor that initializes an edge with an origin station, a destination station, a capacity and a service.
      *
-     * @note This constructor initializes reverse as nullptr and flow as 0.
+     * @note This constructor initializes reverse as nullptr and id and the positions in the stations as -1.
      *
      * @param origin The station where this edge starts.
      * @param dest The station where this edge ends.
      * @param capacity The maximum number of trains that can simultaneously travel in this edge.
      * @param service The type of service that it provides, which can be either STANDARD or ALFA PENDULAR.
      */
-    Edge(Station* origin, Station* dest, const double capacity, const std::string& service);
+    Edge(Station* origin, Station* dest, const double capacity, ServiceMask service);
 
     /**
      * @brief Gets the station where this edge starts.
@@ -349,9 +399,9 @@ public:
      *
      * @note Complexity time: O(1).
      *
-     * @return The name of the service.
+     * @return The service.
      */
-    std::string getService() const;
+    ServiceMask getService() const;
 
     /**
      * @brief Sets the reverse edge that connects the destination station to this station.
@@ -372,22 +422,24 @@ public:
     Edge* getReverse() const;
 
     /**
-     * @brief Gets the current number of trains that can travel in this edge (flow).
+     * @brief Sets the index of this edge in a numbering of the lines of the graph.
      *
      * @note Complexity time: O(1).
      *
-     * @return The flow.
+     * @param id The index.
      */
-    double getFlow() const;
+    void setId(int id);
 
     /**
-     * @brief Sets the current number of trains that can travel in edge (flow).
+     * @brief Gets the index of this edge in the last numbering of the lines of the graph.
      *
      * @note Complexity time: O(1).
      *
-     * @param flow The flow.
+     * @return The index.
      */
-    void setFlow(double flow);
+    int getId() const;
+
+    friend class Station;
 };
 
 #endif
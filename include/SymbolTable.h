@@ -0,0 +1,78 @@
+#ifndef DA_PROJ1_SYMBOLTABLE_H
+#define DA_PROJ1_SYMBOLTABLE_H
+
+#include <string>
+#include <string_view>
+#include <deque>
+#include <unordered_map>
+#include <mutex>
+
+class SymbolTable;
+
+/**
+ * @brief The id of an interned string. Two equal strings always have the same id.
+ */
+typedef int Symbol;
+
+/**
+ * @brief Stores each distinct string once and gives it a small integer id.
+ *
+ * The attributes that repeat across many stations (district, municipality, township and line) are kept as symbols,
+ * so each station holds a few integers instead of copies of the same strings, and grouping or comparing stations by
+ * those attributes only compares integers.
+ */
+class SymbolTable {
+    /**
+     * @brief The strings, indexed by their id. A deque never moves its elements, so references to them stay valid.
+     */
+    std::deque<std::string> strings;
+
+    /**
+     * @brief The id of each string. The keys are views into strings.
+     */
+    std::unordered_map<std::string_view, Symbol> index;
+
+    /**
+     * @brief Protects the table, so strings can be interned and read from several threads.
+     */
+    mutable std::mutex mutex;
+
+public:
+    /**
+     * @brief Gets the table shared by every station.
+     *
+     * @return The global symbol table.
+     */
+    static SymbolTable& global();
+
+    /**
+     * @brief Gets the id of a string, adding it to the table if it is new.
+     *
+     * @note Complexity time: O(n), n being the length of the string.
+     *
+     * @param s The string.
+     * @return The id of the string.
+     */
+    Symbol intern(std::string_view s);
+
+    /**
+     * @brief Gets the string with a given id.
+     *
+     * @note Complexity time: O(1).
+     *
+     * @param symbol The id, returned by intern.
+     * @return The string. The reference is valid for as long as the table exists.
+     */
+    const std::string& getString(Symbol symbol) const;
+
+    /**
+     * @brief Gets the number of distinct strings in the table. Every id is smaller than this number.
+     *
+     * @note Complexity time: O(1).
+     *
+     * @return The number of strings.
+     */
+    int size() const;
+};
+
+#endif //DA_PROJ1_SYMBOLTABLE_H
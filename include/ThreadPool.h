@@ -0,0 +1,125 @@
+#ifndef DA_PROJ1_THREADPOOL_H
+#define DA_PROJ1_THREADPOOL_H
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+class ThreadPool;
+
+/**
+ * @brief A fixed set of worker threads that execute the iterations of parallel loops.
+ *
+ * The iterations are handed out one at a time from a shared counter, so a worker that finishes early takes the next
+ * pending iteration instead of waiting for the others.
+ */
+class ThreadPool {
+    /**
+     * @brief The worker threads. The thread that calls parallelFor also works, as worker 0.
+     */
+    std::vector<std::thread> workers;
+
+    /**
+     * @brief Protects the state of the current loop.
+     */
+    std::mutex mutex;
+
+    /**
+     * @brief Only one loop runs at a time.
+     */
+    std::mutex loopMutex;
+
+    /**
+     * @brief Wakes the workers when a loop starts or the pool is destroyed.
+     */
+    std::condition_variable wake;
+
+    /**
+     * @brief Wakes the caller of parallelFor when every worker is done.
+     */
+    std::condition_variable done;
+
+    /**
+     * @brief The body of the current loop.
+     */
+    std::function<void(int, int)> body;
+
+    /**
+     * @brief The number of iterations of the current loop.
+     */
+    int iterations = 0;
+
+    /**
+     * @brief The next iteration to be executed.
+     */
+    std::atomic<int> next{0};
+
+    /**
+     * @brief The number of workers still executing the current loop.
+     */
+    int running = 0;
+
+    /**
+     * @brief Incremented every time a loop starts.
+     */
+    unsigned generation = 0;
+
+    /**
+     * @brief True when the pool is being destroyed.
+     */
+    bool stopping = false;
+
+    /**
+     * @brief The main function of a worker thread.
+     *
+     * @param worker The index of the worker.
+     */
+    void workerLoop(int worker);
+
+    /**
+     * @brief Executes iterations of the current loop until there are none left.
+     *
+     * @param worker The index of the worker.
+     */
+    void work(int worker);
+
+public:
+    /**
+     * @brief Creates a pool with the given number of workers, including the calling thread.
+     *
+     * @param size The number of workers. One per hardware thread by default.
+     */
+    explicit ThreadPool(unsigned size = std::thread::hardware_concurrency());
+
+    /**
+     * @brief Stops and joins every worker thread.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief Gets the number of workers, including the calling thread.
+     *
+     * @note Complexity time: O(1).
+     *
+     * @return The number of workers.
+     */
+    int size() const;
+
+    /**
+     * @brief Executes body(i, worker) for every i in [0, n) and waits for all of them to finish.
+     *
+     * @note Iterations run concurrently and in no particular order; the worker index (in [0, size())) lets the body use per-worker state.
+     *
+     * @param n The number of iterations.
+     * @param body The body of the loop.
+     */
+    void parallelFor(int n, const std::function<void(int, int)>& body);
+};
+
+#endif //DA_PROJ1_THREADPOOL_H
@@ -1,13 +1,36 @@
 #ifndef DA_PROJ1_USERINTERFACE_H
 #define DA_PROJ1_USERINTERFACE_H
 
+#include <string>
+
+#include "MaxFlowEngine.h"
+#include "constants.h"
+
 class UserInterface;
 
 /**
  * @brief A simple menu to use the program.
  */
 class UserInterface {
+    /**
+     * @brief The algorithm used to compute the maximum flows.
+     */
+    MaxFlowAlgorithm algorithm;
+
+    /**
+     * @brief The directory of the dataset.
+     */
+    std::string datasetDirectory;
+
 public:
+    /**
+     * @brief Creates a menu that computes maximum flows with the given algorithm.
+     *
+     * @param algorithm The max flow algorithm. Edmonds-Karp by default.
+     * @param datasetDirectory The directory of the dataset (see Graph::setDatasetDirectory).
+     */
+    explicit UserInterface(MaxFlowAlgorithm algorithm = EDMONDS_KARP, const std::string& datasetDirectory = DATASET_DIRECTORY);
+
     /**
      * @brief Displays the menu.
      */
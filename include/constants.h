@@ -4,14 +4,34 @@
 #include <string>
 
 /**
- * @brief Where the stations are stored.
+ * @brief The directory of the dataset used by default (see Graph::setDatasetDirectory).
 */
-const std::string STATIONS_FILE_PATH = "../dataset/stations.csv";
+const std::string DATASET_DIRECTORY = "../dataset";
 
 /**
- * @brief Where the network(edges) are stored.
+ * @brief The name of the file where the stations are stored.
 */
-const std::string NETWORK_FILE_PATH = "../dataset/network.csv";
+const std::string STATIONS_FILE_NAME = "stations.csv";
+
+/**
+ * @brief The name of the file where the network(edges) are stored.
+*/
+const std::string NETWORK_FILE_NAME = "network.csv";
+
+/**
+ * @brief The name of the file where the binary version of the dataset is stored (see BinaryDataset.h).
+*/
+const std::string BINARY_DATASET_NAME = "dataset.bin";
+
+/**
+ * @brief The name of the file where the contraction hierarchy of the STANDARD lines is stored (see ContractionHierarchy.h).
+*/
+const std::string STANDARD_ROUTE_INDEX_NAME = "standard.ch";
+
+/**
+ * @brief The name of the file where the contraction hierarchy of the ALFA PENDULAR lines is stored (see ContractionHierarchy.h).
+*/
+const std::string ALFA_PENDULAR_ROUTE_INDEX_NAME = "alfa_pendular.ch";
 
 /**
  * @brief The cost of a standard train per train and per segment.
@@ -0,0 +1,293 @@
+#include <string>
+#include <vector>
+#include <sstream>
+#include <charconv>
+
+#include "../include/BatchRunner.h"
+#include "../include/CSVReader.h"
+
+/**
+ * @brief The error of the queries whose stations do not exist or are the same station.
+ */
+static const std::string INVALID_STATIONS = "a station does not exist or both stations are the same";
+
+/**
+ * @brief The error of the queries whose stations are not connected.
+ */
+static const std::string NO_PATH = "there is no path between the stations";
+
+bool parseBatchFormat(const std::string &name, BatchFormat &format) {
+    if (name == "jsonl") format = FORMAT_JSON_LINES;
+    else if (name == "csv") format = FORMAT_CSV;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief Sees if a query has the fields its command needs.
+ *
+ * @param command The command of the query.
+ * @param numArgs The number of fields after the command.
+ * @return True if the command is known and has the right number of fields.
+ */
+static bool isWellFormed(const std::string& command, std::size_t numArgs) {
+    if (command == "maxflow" || command == "mincost") return numArgs == 2;
+    if (command == "grid-to-station") return numArgs == 1;
+    if (command == "what-if") return numArgs >= 2 && numArgs % 2 == 0;
+    return false;
+}
+
+/**
+ * @brief Appends a number in its shortest exact form (integers without decimals).
+ */
+static void appendNumber(std::string& buffer, double value) {
+    char text[32];
+    auto result = std::to_chars(text, text + sizeof(text), value);
+    buffer.append(text, result.ptr);
+}
+
+/**
+ * @brief Appends a JSON string, escaping the quotes, backslashes and control characters.
+ */
+static void appendJsonString(std::string& buffer, const std::string& value) {
+    static const char* HEX = "0123456789abcdef";
+    buffer += '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            buffer += '\\';
+            buffer += c;
+        }
+        else if ((unsigned char) c < 0x20) {
+            buffer += "\\u00";
+            buffer += HEX[(c >> 4) & 0xF];
+            buffer += HEX[c & 0xF];
+        }
+        else buffer += c;
+    }
+    buffer += '"';
+}
+
+/**
+ * @brief Appends a CSV field, quoted only if it has commas, quotes or line breaks.
+ */
+static void appendCsvField(std::string& buffer, const std::string& value) {
+    if (value.find_first_of(",\"\r\n") == std::string::npos) {
+        buffer += value;
+        return;
+    }
+    buffer += '"';
+    for (char c : value) {
+        if (c == '"') buffer += '"';
+        buffer += c;
+    }
+    buffer += '"';
+}
+
+BatchRunner::BatchRunner(Graph &graph, BatchFormat format, bool parallel): graph(graph), format(format), parallel(parallel) {}
+
+BatchRunner::Result BatchRunner::execute(const Query &query) {
+    Result result;
+    const std::vector<std::string>& args = query.args;
+    if (!isWellFormed(query.command, args.size())) {
+        result.error = "unknown query or wrong number of fields";
+        return result;
+    }
+
+    if (query.command == "maxflow") {
+        result.flow = graph.maxFlow(args[0], args[1], context);
+    }
+    else if (query.command == "mincost") {
+        std::pair<double, double> res = graph.maxFlowMinCost(args[0], args[1], result.service, context);
+        result.cost = res.first;
+        result.flow = res.second;
+    }
+    else if (query.command == "grid-to-station") {
+        //a funcao do grafo devolve -1 tanto para estacoes que nao existem como para as que nao sao alcancaveis
+        if (graph.findStation(args[0]) == nullptr) result.flow = -2;
+        else result.flow = graph.maxFlowGridToStation(args[0], context);
+    }
+    else {
+        std::vector<std::pair<std::string, std::string>> linesToRemove;
+        for (std::size_t i = 2; i < args.size(); i += 2) {
+            linesToRemove.emplace_back(args[i], args[i + 1]);
+        }
+        result.flow = graph.maxFlowSubGraph(linesToRemove, args[0], args[1], context);
+    }
+
+    if (result.flow == -2) result.error = INVALID_STATIONS;
+    else if (result.flow == -1) result.error = NO_PATH;
+    return result;
+}
+
+void BatchRunner::executeGroup(const std::vector<const Query *> &queries, std::vector<Result> &results) {
+    results.assign(queries.size(), Result());
+    std::vector<double> flows;
+
+    if (queries[0]->command == "maxflow") {
+        std::vector<std::pair<Station*, Station*>> pairs;
+        for (const Query* query : queries) {
+            pairs.emplace_back(graph.findStation(query->args[0]), graph.findStation(query->args[1]));
+        }
+        flows = graph.maxFlows(pairs);
+    }
+    else {
+        std::vector<Station*> targets;
+        for (const Query* query : queries) {
+            targets.push_back(graph.findStation(query->args[0]));
+        }
+        flows = graph.maxFlowsFromSources(graph.getLeaves(), targets);
+    }
+
+    for (std::size_t i = 0; i < queries.size(); i++) {
+        results[i].flow = flows[i];
+        if (flows[i] == -2) results[i].error = INVALID_STATIONS;
+        else if (flows[i] == -1) results[i].error = NO_PATH;
+    }
+}
+
+void BatchRunner::append(const Query &query, const Result &result) {
+    bool ok = result.error.empty();
+    bool wellFormed = isWellFormed(query.command, query.args.size());
+    std::string origin, destination;
+    if (wellFormed && query.command == "grid-to-station") destination = query.args[0];
+    else if (wellFormed) {
+        origin = query.args[0];
+        destination = query.args[1];
+    }
+
+    if (format == FORMAT_JSON_LINES) {
+        buffer += "{\"line\":";
+        appendNumber(buffer, query.line);
+        buffer += ",\"query\":";
+        appendJsonString(buffer, query.command);
+        if (!origin.empty()) {
+            buffer += ",\"origin\":";
+            appendJsonString(buffer, origin);
+        }
+        if (!destination.empty()) {
+            buffer += ",\"destination\":";
+            appendJsonString(buffer, destination);
+        }
+        if (ok) {
+            buffer += ",\"flow\":";
+            appendNumber(buffer, result.flow);
+            if (query.command == "mincost") {
+                buffer += ",\"cost\":";
+                appendNumber(buffer, result.cost);
+                buffer += ",\"service\":";
+                appendJsonString(buffer, result.service);
+            }
+        }
+        else {
+            buffer += ",\"error\":";
+            appendJsonString(buffer, result.error);
+        }
+        buffer += "}\n";
+    }
+    else {
+        appendNumber(buffer, query.line);
+        buffer += ',';
+        appendCsvField(buffer, query.command);
+        buffer += ',';
+        appendCsvField(buffer, origin);
+        buffer += ',';
+        appendCsvField(buffer, destination);
+        buffer += ',';
+        if (ok) appendNumber(buffer, result.flow);
+        buffer += ',';
+        if (ok && query.command == "mincost") appendNumber(buffer, result.cost);
+        buffer += ',';
+        if (ok) appendCsvField(buffer, result.service);
+        buffer += ',';
+        appendCsvField(buffer, result.error);
+        buffer += '\n';
+    }
+}
+
+void BatchRunner::flushIfFull(std::ostream &out) {
+    if (buffer.size() < BUFFER_SIZE) return;
+    out.write(buffer.data(), (std::streamsize) buffer.size());
+    buffer.clear();
+}
+
+void BatchRunner::flush(std::ostream &out) {
+    out.write(buffer.data(), (std::streamsize) buffer.size());
+    buffer.clear();
+    out.flush();
+}
+
+void BatchRunner::runGroup(std::vector<Query> &group, std::ostream &out) {
+    std::vector<const Query*> queries;
+    for (const Query& query : group) queries.push_back(&query);
+    std::vector<Result> results;
+    executeGroup(queries, results);
+    for (std::size_t i = 0; i < group.size(); i++) {
+        append(group[i], results[i]);
+        flushIfFull(out);
+    }
+    group.clear();
+}
+
+bool BatchRunner::run(std::istream &in, const std::string &name, std::ostream &out) {
+    CSVReader reader(in, name);
+    if (!reader.isOpen()) return false;
+
+    buffer.clear();
+    if (format == FORMAT_CSV) buffer += "line,query,origin,destination,flow,cost,service,error\n";
+
+    //as perguntas seguintes do mesmo tipo sao juntadas para as calcular em paralelo
+    std::vector<Query> group;
+    std::vector<std::string_view> fields;
+    while (true) {
+        //sem mais linhas prontas a entrada pode ficar a espera, por isso as respostas pendentes saem ja
+        if (in.rdbuf()->in_avail() <= 0) {
+            if (!group.empty()) runGroup(group, out);
+            flush(out);
+        }
+        if (!reader.readRow(fields)) break;
+
+        //linhas comecadas por # sao comentarios
+        if (fields[0].empty() || fields[0][0] == '#') continue;
+        Query query{reader.getLineNumber(), std::string(fields[0]), {}};
+        for (std::size_t i = 1; i < fields.size(); i++) {
+            query.args.emplace_back(fields[i]);
+        }
+
+        bool groupable = parallel && (query.command == "maxflow" || query.command == "grid-to-station") &&
+                         isWellFormed(query.command, query.args.size());
+        if (!group.empty() && (!groupable || query.command != group[0].command || group.size() >= MAX_GROUP_SIZE)) {
+            runGroup(group, out);
+        }
+        if (groupable) {
+            group.push_back(std::move(query));
+            continue;
+        }
+        append(query, execute(query));
+        flushIfFull(out);
+    }
+
+    if (!group.empty()) runGroup(group, out);
+    flush(out);
+    return true;
+}
+
+std::string BatchRunner::answer(const std::string &row, int line) {
+    std::istringstream in(row);
+    CSVReader reader(in, "query");
+    std::vector<std::string_view> fields;
+
+    Query query{line, "", {}};
+    if (reader.readRow(fields)) {
+        query.command = std::string(fields[0]);
+        for (std::size_t i = 1; i < fields.size(); i++) {
+            query.args.emplace_back(fields[i]);
+        }
+    }
+
+    buffer.clear();
+    append(query, execute(query));
+    std::string result;
+    result.swap(buffer);
+    if (!result.empty() && result.back() == '\n') result.pop_back();
+    return result;
+}
@@ -0,0 +1,209 @@
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <filesystem>
+#include <cstring>
+
+#include "../include/BinaryDataset.h"
+#include "../include/BinaryIO.h"
+#include "../include/Graph.h"
+
+/**
+ * @brief The first bytes of every binary dataset.
+ */
+static const char MAGIC[8] = {'D', 'A', 'P', 'R', 'O', 'J', '1', 'B'};
+
+/**
+ * @brief Written in the header to detect files written on a machine with another byte order.
+ */
+static const std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+/**
+ * @brief The reverse of the lines that have no reverse.
+ */
+static const std::uint32_t NO_REVERSE = 0xFFFFFFFF;
+
+/**
+ * @brief The number of strings of each station record (name, district, municipality, township and line).
+ */
+static const std::size_t STATION_STRINGS = 5;
+
+static void fingerprintFile(const std::string& path, std::uint64_t& size, std::uint64_t& time) {
+    std::error_code error;
+    auto fileSize = std::filesystem::file_size(path, error);
+    if (error) return;
+    auto fileTime = std::filesystem::last_write_time(path, error);
+    if (error) return;
+    size = fileSize;
+    time = (std::uint64_t) fileTime.time_since_epoch().count();
+}
+
+DatasetFingerprint fingerprintDataset(const std::string &stationsPath, const std::string &networkPath) {
+    DatasetFingerprint fingerprint;
+    fingerprintFile(stationsPath, fingerprint.stationsSize, fingerprint.stationsTime);
+    fingerprintFile(networkPath, fingerprint.networkSize, fingerprint.networkTime);
+    return fingerprint;
+}
+
+bool writeBinaryDataset(const Graph &graph, const std::string &path, const DatasetFingerprint &source) {
+    const std::vector<Station*>& stations = graph.getStationSet();
+
+    //tabela de strings: cada string diferente e guardada uma unica vez
+    std::unordered_map<std::string, std::uint32_t> stringIndex;
+    std::vector<std::uint32_t> stringOffsets(1, 0);
+    std::string chars;
+    auto intern = [&](const std::string& s) {
+        auto it = stringIndex.emplace(s, (std::uint32_t) stringIndex.size());
+        if (it.second) {
+            chars += s;
+            stringOffsets.push_back((std::uint32_t) chars.size());
+        }
+        return it.first->second;
+    };
+
+    //as estacoes e as linhas sao numeradas pela ordem do grafo
+    std::vector<std::uint32_t> stationStrings;
+    std::vector<std::uint32_t> offsets(1, 0);
+    int numLines = 0;
+    for (int i = 0; i < (int) stations.size(); i++) {
+        Station* v = stations[i];
+        v->setId(i);
+        stationStrings.push_back(intern(v->getName()));
+        stationStrings.push_back(intern(v->getDistrict()));
+        stationStrings.push_back(intern(v->getMunicipality()));
+        stationStrings.push_back(intern(v->getTownShip()));
+        stationStrings.push_back(intern(v->getLine()));
+        for (auto e : v->getAdj()) {
+            e->setId(numLines++);
+        }
+        offsets.push_back((std::uint32_t) numLines);
+    }
+
+    std::vector<std::uint32_t> targets, reverse;
+    std::vector<double> capacity;
+    std::vector<ServiceMask> service;
+    for (auto v : stations) {
+        for (auto e : v->getAdj()) {
+            targets.push_back((std::uint32_t) e->getDest()->getId());
+            reverse.push_back(e->getReverse() != nullptr ? (std::uint32_t) e->getReverse()->getId() : NO_REVERSE);
+            capacity.push_back(e->getCapacity());
+            service.push_back(e->getService());
+        }
+    }
+
+    std::string payload;
+    put(payload, (std::uint32_t) stringIndex.size());
+    put(payload, (std::uint32_t) chars.size());
+    putArray(payload, stringOffsets);
+    payload += chars;
+    put(payload, (std::uint32_t) stations.size());
+    putArray(payload, stationStrings);
+    put(payload, (std::uint32_t) targets.size());
+    putArray(payload, offsets);
+    putArray(payload, targets);
+    putArray(payload, reverse);
+    putArray(payload, capacity);
+    putArray(payload, service);
+
+    std::string header(MAGIC, sizeof(MAGIC));
+    put(header, BINARY_DATASET_VERSION);
+    put(header, BYTE_ORDER_MARK);
+    put(header, source.stationsSize);
+    put(header, source.stationsTime);
+    put(header, source.networkSize);
+    put(header, source.networkTime);
+    put(header, fnv1a(payload.data(), payload.size()));
+
+    return writeFileAtomically(path, header, payload);
+}
+
+bool readBinaryDataset(Graph &graph, const std::string &path, const DatasetFingerprint &source) {
+    if (!graph.getStationSet().empty()) return false;
+
+    std::vector<char> contents;
+    if (!readWholeFile(path, contents)) return false;
+
+    BinaryReader in{contents.data(), contents.size()};
+
+    //cabecalho
+    char magic[sizeof(MAGIC)];
+    std::uint32_t version, byteOrder;
+    DatasetFingerprint fingerprint;
+    std::uint64_t expectedChecksum;
+    for (char& c : magic) {
+        if (!in.get(c)) return false;
+    }
+    if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) return false;
+    if (!in.get(version) || version != BINARY_DATASET_VERSION) return false;
+    if (!in.get(byteOrder) || byteOrder != BYTE_ORDER_MARK) return false;
+    if (!in.get(fingerprint.stationsSize) || !in.get(fingerprint.stationsTime) ||
+        !in.get(fingerprint.networkSize) || !in.get(fingerprint.networkTime)) return false;
+    if (!(fingerprint == source)) return false;
+    if (!in.get(expectedChecksum)) return false;
+    if (fnv1a(in.data + in.position, in.size - in.position) != expectedChecksum) return false;
+
+    //tabela de strings
+    std::uint32_t numStrings, numChars;
+    std::vector<std::uint32_t> stringOffsets;
+    std::vector<char> chars;
+    if (!in.get(numStrings) || !in.get(numChars)) return false;
+    if (!in.getArray(stringOffsets, (std::size_t) numStrings + 1) || !in.getArray(chars, numChars)) return false;
+    if (stringOffsets[0] != 0 || stringOffsets[numStrings] != numChars) return false;
+    for (std::uint32_t i = 0; i < numStrings; i++) {
+        if (stringOffsets[i] > stringOffsets[i + 1]) return false;
+    }
+
+    //estacoes e linhas
+    std::uint32_t numStations, numLines;
+    std::vector<std::uint32_t> stationStrings, offsets, targets, reverse;
+    std::vector<double> capacity;
+    std::vector<ServiceMask> service;
+    if (!in.get(numStations) || !in.getArray(stationStrings, (std::size_t) numStations * STATION_STRINGS)) return false;
+    if (!in.get(numLines) || !in.getArray(offsets, (std::size_t) numStations + 1)) return false;
+    if (!in.getArray(targets, numLines) || !in.getArray(reverse, numLines) ||
+        !in.getArray(capacity, numLines) || !in.getArray(service, numLines)) return false;
+    if (in.position != in.size) return false;
+
+    //valida tudo antes de alterar o grafo
+    std::unordered_set<std::uint32_t> names;
+    for (std::size_t i = 0; i < stationStrings.size(); i++) {
+        std::uint32_t s = stationStrings[i];
+        if (s >= numStrings || stringOffsets[s] == stringOffsets[s + 1]) return false;
+        if (i % STATION_STRINGS == 0 && !names.insert(s).second) return false;
+    }
+    if (offsets[0] != 0 || offsets[numStations] != numLines) return false;
+    std::vector<std::uint32_t> origin(numLines);
+    for (std::uint32_t v = 0; v < numStations; v++) {
+        if (offsets[v] > offsets[v + 1]) return false;
+        for (std::uint32_t e = offsets[v]; e < offsets[v + 1]; e++) origin[e] = v;
+    }
+    for (std::uint32_t e = 0; e < numLines; e++) {
+        if (targets[e] >= numStations) return false;
+        if (reverse[e] == NO_REVERSE) continue;
+        std::uint32_t r = reverse[e];
+        if (r >= numLines || reverse[r] != e || origin[r] != targets[e] || targets[r] != origin[e]) return false;
+    }
+
+    auto getString = [&](std::uint32_t s) {
+        return std::string(chars.data() + stringOffsets[s], stringOffsets[s + 1] - stringOffsets[s]);
+    };
+
+    for (std::uint32_t v = 0; v < numStations; v++) {
+        const std::uint32_t* s = &stationStrings[(std::size_t) v * STATION_STRINGS];
+        graph.addStation(getString(s[0]), getString(s[1]), getString(s[2]), getString(s[3]), getString(s[4]));
+    }
+
+    const std::vector<Station*>& stations = graph.getStationSet();
+    std::vector<Edge*> lines(numLines);
+    for (std::uint32_t v = 0; v < numStations; v++) {
+        for (std::uint32_t e = offsets[v]; e < offsets[v + 1]; e++) {
+            lines[e] = stations[v]->addLine(stations[targets[e]], capacity[e], service[e]);
+        }
+    }
+    for (std::uint32_t e = 0; e < numLines; e++) {
+        if (reverse[e] != NO_REVERSE) lines[e]->setReverse(lines[reverse[e]]);
+    }
+
+    return true;
+}
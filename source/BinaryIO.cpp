@@ -0,0 +1,25 @@
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <cstdio>
+
+#include "../include/BinaryIO.h"
+
+bool writeFileAtomically(const std::string &path, const std::string &header, const std::string &payload) {
+    //escreve num ficheiro temporario para nunca deixar um ficheiro incompleto no lugar do anterior
+    std::string temporary = path + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (file.fail()) return false;
+        file.write(header.data(), (std::streamsize) header.size());
+        file.write(payload.data(), (std::streamsize) payload.size());
+        if (file.fail()) {
+            file.close();
+            std::remove(temporary.c_str());
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(temporary, path, error);
+    return !error;
+}
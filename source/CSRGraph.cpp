@@ -0,0 +1,270 @@
+#include <vector>
+#include <stack>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+#include "../include/CSRGraph.h"
+#include "../include/BinaryIO.h"
+
+CSRGraph::CSRGraph(const std::vector<Station*>& stations) {
+    int n = (int) stations.size();
+    std::vector<const Edge*> lines;
+    std::vector<int> degree(n, 0);
+
+    for (int i = 0; i < n; i++) {
+        stations[i]->setId(i);
+    }
+
+    //numera as arestas para as indexar sem tabela de dispersao
+    for (auto v : stations) {
+        for (auto e : v->getAdj()) {
+            e->setId((int) lines.size());
+            lines.push_back(e);
+        }
+    }
+    int numLines = (int) lines.size();
+
+    auto hasReverse = [&lines, numLines](const Edge* e) {
+        const Edge* r = e->getReverse();
+        return r != nullptr && r->getId() >= 0 && r->getId() < numLines && lines[r->getId()] == r &&
+               r->getReverse() == e && r->getOrigin() == e->getDest();
+    };
+
+    for (auto v : stations) {
+        for (auto e : v->getAdj()) {
+            degree[v->getId()]++;
+            if (!hasReverse(e)) degree[e->getDest()->getId()]++;
+        }
+    }
+
+    offsets.assign(n + 1, 0);
+    for (int i = 0; i < n; i++) {
+        offsets[i + 1] = offsets[i] + degree[i];
+    }
+
+    int total = offsets[n];
+    targets.assign(total, 0);
+    reverse.assign(total, 0);
+    capacity.assign(total, 0);
+    service.assign(total, SERVICE_NONE);
+
+    //as arestas do grafo ficam primeiro, pela mesma ordem, seguidas das residuais
+    std::vector<int> next(offsets.begin(), offsets.end() - 1);
+    std::vector<int> position(numLines);
+    for (auto v : stations) {
+        for (auto e : v->getAdj()) {
+            int i = next[v->getId()]++;
+            position[e->getId()] = i;
+            targets[i] = e->getDest()->getId();
+            capacity[i] = e->getCapacity();
+            service[i] = e->getService();
+        }
+    }
+
+    for (auto v : stations) {
+        for (auto e : v->getAdj()) {
+            int i = position[e->getId()];
+            if (hasReverse(e)) {
+                reverse[i] = position[e->getReverse()->getId()];
+            }
+            else {
+                int j = next[e->getDest()->getId()]++;
+                targets[j] = v->getId();
+                reverse[i] = j;
+                reverse[j] = i;
+            }
+        }
+    }
+}
+
+CSRGraph::CSRGraph(const CSRGraph& graph, const std::vector<int>& sources, double capacity, ServiceMask service) {
+    int n = graph.getNumStations();
+    std::vector<int> extra(n + 1, 0);
+    for (int v : sources) {
+        extra[v]++;
+    }
+    extra[n] = (int) sources.size();
+
+    offsets.assign(n + 2, 0);
+    for (int i = 0; i <= n; i++) {
+        int degree = i < n ? graph.end(i) - graph.begin(i) : 0;
+        offsets[i + 1] = offsets[i] + degree + extra[i];
+    }
+
+    int total = offsets[n + 1];
+    targets.assign(total, 0);
+    reverse.assign(total, 0);
+    this->capacity.assign(total, 0);
+    this->service.assign(total, SERVICE_NONE);
+
+    //as arestas de cada estacao mantem a ordem, seguidas das arestas da super source
+    std::vector<int> next(n + 1);
+    for (int v = 0; v < n; v++) {
+        for (int e = graph.begin(v); e < graph.end(v); e++) {
+            int i = offsets[v] + (e - graph.begin(v));
+            int r = graph.getReverse(e);
+            int w = graph.getTarget(e);
+            targets[i] = w;
+            reverse[i] = offsets[w] + (r - graph.begin(w));
+            this->capacity[i] = graph.getCapacity(e);
+            this->service[i] = graph.getService(e);
+        }
+        next[v] = offsets[v] + graph.end(v) - graph.begin(v);
+    }
+    next[n] = offsets[n];
+
+    for (int v : sources) {
+        int i = next[n]++;
+        int j = next[v]++;
+        targets[i] = v;
+        targets[j] = n;
+        reverse[i] = j;
+        reverse[j] = i;
+        this->capacity[i] = this->capacity[j] = capacity;
+        this->service[i] = this->service[j] = service;
+    }
+}
+
+CSRGraph::CSRGraph(const CSRGraph& graph, const std::vector<int>& stations) {
+    int n = (int) stations.size();
+    std::vector<int> id(graph.getNumStations(), -1);
+    for (int i = 0; i < n; i++) {
+        id[stations[i]] = i;
+    }
+
+    //so ficam as arestas com as duas estacoes no subgrafo, por isso a reversa de cada uma tambem fica
+    std::vector<int> position(graph.getNumLines(), -1);
+    offsets.assign(n + 1, 0);
+    for (int i = 0; i < n; i++) {
+        offsets[i + 1] = offsets[i];
+        for (int e = graph.begin(stations[i]); e < graph.end(stations[i]); e++) {
+            if (id[graph.getTarget(e)] != -1) position[e] = offsets[i + 1]++;
+        }
+    }
+
+    int total = offsets[n];
+    targets.assign(total, 0);
+    reverse.assign(total, 0);
+    capacity.assign(total, 0);
+    service.assign(total, SERVICE_NONE);
+
+    for (int v : stations) {
+        for (int e = graph.begin(v); e < graph.end(v); e++) {
+            int i = position[e];
+            if (i == -1) continue;
+            targets[i] = id[graph.getTarget(e)];
+            reverse[i] = position[graph.getReverse(e)];
+            capacity[i] = graph.getCapacity(e);
+            service[i] = graph.getService(e);
+        }
+    }
+}
+
+int CSRGraph::getNumStations() const {
+    return (int) offsets.size() - 1;
+}
+
+int CSRGraph::getNumLines() const {
+    return (int) targets.size();
+}
+
+bool CSRGraph::isUndirected() const {
+    for (int e = 0; e < getNumLines(); e++) {
+        if (service[e] == SERVICE_NONE || capacity[e] != capacity[reverse[e]]) return false;
+    }
+    return true;
+}
+
+bool CSRGraph::hasIntegerCapacities() const {
+    //acima de 2^53 nem todos os inteiros sao representaveis num double
+    const double limit = 9007199254740992.0;
+    double total = 0;
+    for (int e = 0; e < getNumLines(); e++) {
+        if (service[e] == SERVICE_NONE) continue;
+        if (capacity[e] < 0 || capacity[e] != std::floor(capacity[e])) return false;
+        total += capacity[e];
+        if (total > limit) return false;
+    }
+    return true;
+}
+
+void CSRGraph::connectedComponents(std::vector<int>& component) const {
+    int n = getNumStations();
+    std::vector<int> stack;
+    component.assign(n, -1);
+
+    for (int i = 0; i < n; i++) {
+        if (component[i] != -1) continue;
+        component[i] = i;
+        stack.push_back(i);
+        while (!stack.empty()) {
+            int v = stack.back();
+            stack.pop_back();
+            for (int e = offsets[v]; e < offsets[v + 1]; e++) {
+                int w = targets[e];
+                if (component[w] == -1) {
+                    component[w] = i;
+                    stack.push_back(w);
+                }
+            }
+        }
+    }
+}
+
+bool CSRGraph::dfs(int s, int t, ServiceMask services) const {
+    std::vector<bool> visited(getNumStations(), false);
+    std::stack<int> stack;
+    visited[s] = true;
+    stack.push(s);
+    while (!stack.empty()) {
+        int v = stack.top();
+        stack.pop();
+        for (int e = offsets[v]; e < offsets[v + 1]; e++) {
+            if (!(service[e] & services)) continue;
+            int w = targets[e];
+            if (w == t) return true;
+            if (!visited[w]) {
+                visited[w] = true;
+                stack.push(w);
+            }
+        }
+    }
+    return false;
+}
+
+bool CSRGraph::dfs(const std::vector<int>& sources, int t, ServiceMask services) const {
+    std::vector<bool> visited(getNumStations(), false);
+    std::stack<int> stack;
+    //o destino nunca e uma origem
+    visited[t] = true;
+    for (int s : sources) {
+        if (visited[s]) continue;
+        visited[s] = true;
+        stack.push(s);
+    }
+    visited[t] = false;
+    while (!stack.empty()) {
+        int v = stack.top();
+        stack.pop();
+        for (int e = offsets[v]; e < offsets[v + 1]; e++) {
+            if (!(service[e] & services)) continue;
+            int w = targets[e];
+            if (w == t) return true;
+            if (!visited[w]) {
+                visited[w] = true;
+                stack.push(w);
+            }
+        }
+    }
+    return false;
+}
+
+std::uint64_t CSRGraph::checksum() const {
+    std::uint64_t hash = FNV_OFFSET_BASIS;
+    hash = fnv1a(offsets.data(), offsets.size() * sizeof(int), hash);
+    hash = fnv1a(targets.data(), targets.size() * sizeof(int), hash);
+    hash = fnv1a(reverse.data(), reverse.size() * sizeof(int), hash);
+    hash = fnv1a(capacity.data(), capacity.size() * sizeof(double), hash);
+    return fnv1a(service.data(), service.size() * sizeof(ServiceMask), hash);
+}
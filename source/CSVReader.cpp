@@ -0,0 +1,164 @@
+#include <vector>
+#include <string>
+#include <string_view>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <charconv>
+#include <system_error>
+
+#include "../include/CSVReader.h"
+
+bool parseDouble(std::string_view field, double &value) {
+    std::size_t first = field.find_first_not_of(" \t");
+    if (first == std::string_view::npos) return false;
+    std::size_t last = field.find_last_not_of(" \t");
+    field = field.substr(first, last - first + 1);
+
+    auto result = std::from_chars(field.data(), field.data() + field.size(), value);
+    return result.ec == std::errc() && result.ptr == field.data() + field.size();
+}
+
+CSVReader::CSVReader(const std::string &path): path(path) {
+    std::ifstream file(path, std::ios::binary);
+    if (file.fail()) return;
+
+    //le o ficheiro todo de uma vez
+    file.seekg(0, std::ios::end);
+    std::streamoff size = file.tellg();
+    file.seekg(0, std::ios::beg);
+    if (size >= 0) {
+        buffer.resize((std::size_t) size);
+        file.read(&buffer[0], size);
+        buffer.resize((std::size_t) file.gcount());
+    }
+    else {
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        buffer = contents.str();
+    }
+    open = true;
+
+    //ignora o BOM do UTF-8
+    if (buffer.compare(0, 3, "\xEF\xBB\xBF") == 0) position = 3;
+}
+
+CSVReader::CSVReader(std::istream &in, const std::string &name): path(name), stream(&in) {
+    fill();
+    open = !in.bad();
+
+    //ignora o BOM do UTF-8
+    if (buffer.compare(0, 3, "\xEF\xBB\xBF") == 0) position = 3;
+}
+
+void CSVReader::fill() {
+    if (stream == nullptr) return;
+    buffer.erase(0, position);
+    position = 0;
+
+    //a linha so acaba quando todas as aspas abertas foram fechadas
+    std::string line;
+    bool quoted = false;
+    while (std::getline(*stream, line)) {
+        for (char c : line) {
+            if (c == '"') quoted = !quoted;
+        }
+        buffer += line;
+        buffer += '\n';
+        if (!quoted && line.find_first_not_of('\r') != std::string::npos) return;
+    }
+}
+
+bool CSVReader::isOpen() const {
+    return open;
+}
+
+int CSVReader::getLineNumber() const {
+    return lineNumber;
+}
+
+void CSVReader::reportError(const std::string &message) const {
+    std::cerr << path << ":" << lineNumber << ": " << message << std::endl;
+}
+
+bool CSVReader::readRow(std::vector<std::string_view> &fields) {
+    while (true) {
+        if (position >= buffer.size()) fill();
+        std::size_t size = buffer.size();
+
+        //ignora linhas vazias
+        while (position < size && (buffer[position] == '\n' || buffer[position] == '\r')) {
+            if (buffer[position] == '\n') nextLine++;
+            position++;
+        }
+        if (position >= size) return false;
+
+        fields.clear();
+        lineNumber = nextLine;
+
+        while (true) {
+            if (position < size && buffer[position] == '"') {
+                if (!readQuotedField(fields)) break;
+            }
+            else {
+                std::size_t start = position;
+                while (position < size && buffer[position] != ',' && buffer[position] != '\n') position++;
+                std::size_t end = position;
+                if (end > start && buffer[end - 1] == '\r') end--;
+                fields.emplace_back(buffer.data() + start, end - start);
+            }
+
+            if (position < size && buffer[position] == ',') {
+                position++;
+                continue;
+            }
+
+            //fim da linha
+            if (position < size) {
+                position++;
+                nextLine++;
+            }
+            return true;
+        }
+
+        reportError("malformed quoted field");
+        skipRow();
+    }
+}
+
+bool CSVReader::readQuotedField(std::vector<std::string_view> &fields) {
+    std::size_t size = buffer.size();
+    position++;
+    std::size_t start = position;
+    std::size_t write = position;
+
+    while (position < size) {
+        char c = buffer[position];
+        if (c == '"') {
+            //"" e uma aspa dentro do campo
+            if (position + 1 < size && buffer[position + 1] == '"') {
+                buffer[write++] = '"';
+                position += 2;
+                continue;
+            }
+            position++;
+            fields.emplace_back(buffer.data() + start, write - start);
+            if (position < size && buffer[position] == '\r') position++;
+            return position == size || buffer[position] == ',' || buffer[position] == '\n';
+        }
+        if (c == '\n') nextLine++;
+        buffer[write++] = c;
+        position++;
+    }
+
+    //as aspas nunca foram fechadas
+    return false;
+}
+
+void CSVReader::skipRow() {
+    while (position < buffer.size() && buffer[position] != '\n') position++;
+    if (position < buffer.size()) {
+        position++;
+        nextLine++;
+    }
+}
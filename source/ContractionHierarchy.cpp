@@ -0,0 +1,402 @@
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include <cstring>
+
+#include "../include/ContractionHierarchy.h"
+#include "../include/MutablePriorityQueue.h"
+#include "../include/RadixHeap.h"
+#include "../include/DaryHeap.h"
+#include "../include/BinaryIO.h"
+
+/**
+ * @brief The distance of the stations that can not be reached.
+ */
+static const double INFINITE_DISTANCE = std::numeric_limits<double>::infinity();
+
+/**
+ * @brief The maximum number of stations settled by a witness search. A search that stops early only adds shortcuts
+ * that may not be needed, never fewer.
+ */
+static const int WITNESS_SETTLE_LIMIT = 500;
+
+/**
+ * @brief The first bytes of every route index.
+ */
+static const char MAGIC[8] = {'D', 'A', 'P', 'R', 'O', 'J', 'C', 'H'};
+
+/**
+ * @brief Written in the header to detect files written on a machine with another byte order.
+ */
+static const std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+ContractionHierarchy::ContractionHierarchy(const CSRGraph &graph, ServiceMask service): service(service), source(graph.checksum()),
+                                                                                   integerCosts(graph.hasIntegerCapacities()) {
+    int n = graph.getNumStations();
+    std::vector<std::vector<int>> out(n), in(n);
+
+    //adiciona um arco, ou torna mais barato o que ja liga as mesmas estacoes
+    auto addArc = [&](int from, int to, double cost, int line, int first, int second) {
+        for (int a : out[from]) {
+            if (arcs[a].to != to) continue;
+            if (cost < arcs[a].cost) arcs[a] = {from, to, cost, line, first, second};
+            return;
+        }
+        out[from].push_back((int) arcs.size());
+        in[to].push_back((int) arcs.size());
+        arcs.push_back({from, to, cost, line, first, second});
+    };
+
+    for (int v = 0; v < n; v++) {
+        for (int e = graph.begin(v); e < graph.end(v); e++) {
+            if ((graph.getService(e) & service) && graph.getTarget(e) != v) addArc(v, graph.getTarget(e), graph.getCapacity(e), e, -1, -1);
+        }
+    }
+
+    std::vector<bool> contracted(n, false);
+    std::vector<int> contractedNeighbours(n, 0);
+    std::vector<double> witness(n, INFINITE_DISTANCE);
+    std::vector<int> touched;
+    DaryHeap<double> q(n);
+
+    //procura caminhos de u que evitem v e nao custem mais do que limit
+    auto witnessSearch = [&](int u, int v, double limit) {
+        for (int w : touched) witness[w] = INFINITE_DISTANCE;
+        touched.clear();
+        q.clear();
+        witness[u] = 0;
+        touched.push_back(u);
+        q.insert(u, 0);
+        int settled = 0;
+        while (!q.empty() && settled < WITNESS_SETTLE_LIMIT) {
+            if (q.topKey() > limit) break;
+            int w = q.extractMin();
+            double d = witness[w];
+            settled++;
+            for (int a : out[w]) {
+                int x = arcs[a].to;
+                if (x == v || contracted[x]) continue;
+                double cost = d + arcs[a].cost;
+                if (cost < witness[x]) {
+                    if (witness[x] == INFINITE_DISTANCE) touched.push_back(x);
+                    witness[x] = cost;
+                    if (q.contains(x)) q.decreaseKey(x, cost);
+                    else q.insert(x, cost);
+                }
+            }
+        }
+    };
+
+    //conta (e, se add, adiciona) os atalhos necessarios para contrair v
+    auto contract = [&](int v, bool add) {
+        int shortcuts = 0;
+        for (int i = 0; i < (int) in[v].size(); i++) {
+            int first = in[v][i];
+            int u = arcs[first].from;
+            if (contracted[u]) continue;
+
+            double maxCost = -1;
+            for (int second : out[v]) {
+                int x = arcs[second].to;
+                if (!contracted[x] && x != u) maxCost = std::max(maxCost, arcs[second].cost);
+            }
+            if (maxCost < 0) continue;
+
+            double cost = arcs[first].cost;
+            witnessSearch(u, v, cost + maxCost);
+            for (int j = 0; j < (int) out[v].size(); j++) {
+                int second = out[v][j];
+                int x = arcs[second].to;
+                if (contracted[x] || x == u) continue;
+                if (witness[x] <= cost + arcs[second].cost) continue;
+                shortcuts++;
+                if (add) addArc(u, x, cost + arcs[second].cost, -1, first, second);
+            }
+        }
+        return shortcuts;
+    };
+
+    auto priority = [&](int v) {
+        int degree = 0;
+        for (int a : in[v]) degree += !contracted[arcs[a].from];
+        for (int a : out[v]) degree += !contracted[arcs[a].to];
+        return contract(v, false) - degree + contractedNeighbours[v];
+    };
+
+    //contrai primeiro as estacoes menos importantes, atualizando a prioridade so quando saem da fila
+    std::vector<std::pair<int, int>> priorities(n);
+    for (int v = 0; v < n; v++) {
+        priorities[v] = {priority(v), v};
+    }
+    DaryHeap<int> order(n);
+    order.heapify(priorities);
+
+    rank.assign(n, 0);
+    int next = 0;
+    while (!order.empty()) {
+        int v = order.extractMin();
+        int p = priority(v);
+        if (!order.empty() && p > order.topKey()) {
+            order.insert(v, p);
+            continue;
+        }
+
+        contract(v, true);
+        contracted[v] = true;
+        rank[v] = next++;
+        for (int a : in[v]) contractedNeighbours[arcs[a].from]++;
+        for (int a : out[v]) contractedNeighbours[arcs[a].to]++;
+    }
+
+    buildUpwardGraph();
+}
+
+void ContractionHierarchy::buildUpwardGraph() {
+    int n = (int) rank.size();
+    for (int side = 0; side < 2; side++) {
+        upOffsets[side].assign(n + 1, 0);
+    }
+
+    //a pesquisa direta sobe pelos arcos que saem de cada estacao, a inversa pelos que chegam
+    for (auto& arc : arcs) {
+        if (rank[arc.from] < rank[arc.to]) upOffsets[0][arc.from + 1]++;
+        else upOffsets[1][arc.to + 1]++;
+    }
+    for (int side = 0; side < 2; side++) {
+        for (int v = 0; v < n; v++) {
+            upOffsets[side][v + 1] += upOffsets[side][v];
+        }
+        upArcs[side].assign(upOffsets[side][n], 0);
+    }
+
+    std::vector<int> position[2] = {std::vector<int>(upOffsets[0].begin(), upOffsets[0].end() - 1),
+                                    std::vector<int>(upOffsets[1].begin(), upOffsets[1].end() - 1)};
+    for (int a = 0; a < (int) arcs.size(); a++) {
+        if (rank[arcs[a].from] < rank[arcs[a].to]) upArcs[0][position[0][arcs[a].from]++] = a;
+        else upArcs[1][position[1][arcs[a].to]++] = a;
+    }
+}
+
+void ContractionHierarchy::prepare(Search &search) const {
+    int n = (int) rank.size();
+    for (int side = 0; side < 2; side++) {
+        search.distance[side].assign(n, 0);
+        search.parent[side].assign(n, -1);
+        search.reached[side].assign(n, 0);
+        search.nodes[side].resize(n);
+        for (int v = 0; v < n; v++) {
+            search.nodes[side][v].id = v;
+        }
+    }
+    search.stamp = 0;
+}
+
+ServiceMask ContractionHierarchy::getService() const {
+    return service;
+}
+
+int ContractionHierarchy::getNumArcs() const {
+    return (int) arcs.size();
+}
+
+void ContractionHierarchy::unpack(int arc, std::vector<int> &lines) const {
+    std::vector<int> stack = {arc};
+    while (!stack.empty()) {
+        int a = stack.back();
+        stack.pop_back();
+        if (arcs[a].line != -1) {
+            lines.push_back(arcs[a].line);
+            continue;
+        }
+        stack.push_back(arcs[a].second);
+        stack.push_back(arcs[a].first);
+    }
+}
+
+bool ContractionHierarchy::shortestPath(int s, int t, std::vector<int> &lines, Search &search) const {
+    lines.clear();
+    if (s == t) return true;
+
+    if (search.nodes[0].size() != rank.size()) prepare(search);
+    if (++search.stamp == 0) {
+        for (int side = 0; side < 2; side++) {
+            std::fill(search.reached[side].begin(), search.reached[side].end(), 0);
+        }
+        search.stamp = 1;
+    }
+
+    if (integerCosts) return searchWith<RadixHeap<QueueNode>>(s, t, lines, search);
+    return searchWith<MutablePriorityQueue<QueueNode>>(s, t, lines, search);
+}
+
+template <class Queue>
+bool ContractionHierarchy::searchWith(int s, int t, std::vector<int> &lines, Search &search) const {
+    std::vector<double>* distance = search.distance;
+    std::vector<int>* parent = search.parent;
+    std::vector<unsigned>* reached = search.reached;
+    std::vector<QueueNode>* nodes = search.nodes;
+    unsigned stamp = search.stamp;
+    Queue queues[2];
+    for (int side = 0; side < 2; side++) {
+        int v = side == 0 ? s : t;
+        distance[side][v] = 0;
+        parent[side][v] = -1;
+        reached[side][v] = stamp;
+        nodes[side][v].key = 0;
+        queues[side].insert(&nodes[side][v]);
+    }
+
+    double best = INFINITE_DISTANCE;
+    int meet = -1;
+    bool done[2] = {false, false};
+
+    int side = 1;
+    while (!done[0] || !done[1]) {
+        side = 1 - side;
+        if (done[side]) continue;
+        if (queues[side].empty()) {
+            done[side] = true;
+            continue;
+        }
+
+        int u = queues[side].extractMin()->id;
+        //as estacoes que faltam nesta pesquisa estao mais longe do que o melhor caminho
+        if (distance[side][u] >= best) {
+            done[side] = true;
+            continue;
+        }
+        if (reached[1 - side][u] == stamp && distance[side][u] + distance[1 - side][u] < best) {
+            best = distance[side][u] + distance[1 - side][u];
+            meet = u;
+        }
+
+        for (int i = upOffsets[side][u]; i < upOffsets[side][u + 1]; i++) {
+            int a = upArcs[side][i];
+            int w = side == 0 ? arcs[a].to : arcs[a].from;
+            double cost = distance[side][u] + arcs[a].cost;
+            if (reached[side][w] != stamp) {
+                distance[side][w] = cost;
+                parent[side][w] = a;
+                reached[side][w] = stamp;
+                nodes[side][w].key = cost;
+                queues[side].insert(&nodes[side][w]);
+            }
+            else if (cost < distance[side][w]) {
+                distance[side][w] = cost;
+                parent[side][w] = a;
+                nodes[side][w].key = cost;
+                queues[side].decreaseKey(&nodes[side][w]);
+            }
+        }
+    }
+
+    if (meet == -1) return false;
+
+    std::vector<int> path;
+    for (int v = meet; parent[0][v] != -1; v = arcs[parent[0][v]].from) {
+        path.push_back(parent[0][v]);
+    }
+    std::reverse(path.begin(), path.end());
+    for (int v = meet; parent[1][v] != -1; v = arcs[parent[1][v]].to) {
+        path.push_back(parent[1][v]);
+    }
+    for (int a : path) {
+        unpack(a, lines);
+    }
+    return true;
+}
+
+bool ContractionHierarchy::save(const std::string &path) const {
+    int n = (int) rank.size();
+    std::vector<int> from, to, line, first, second;
+    std::vector<double> cost;
+    for (auto& arc : arcs) {
+        from.push_back(arc.from);
+        to.push_back(arc.to);
+        cost.push_back(arc.cost);
+        line.push_back(arc.line);
+        first.push_back(arc.first);
+        second.push_back(arc.second);
+    }
+
+    std::string payload;
+    put(payload, (std::uint32_t) n);
+    put(payload, (std::uint32_t) arcs.size());
+    putArray(payload, rank);
+    putArray(payload, from);
+    putArray(payload, to);
+    putArray(payload, cost);
+    putArray(payload, line);
+    putArray(payload, first);
+    putArray(payload, second);
+
+    std::string header(MAGIC, sizeof(MAGIC));
+    put(header, ROUTE_INDEX_VERSION);
+    put(header, BYTE_ORDER_MARK);
+    put(header, (std::uint32_t) service);
+    put(header, source);
+    put(header, fnv1a(payload.data(), payload.size()));
+
+    return writeFileAtomically(path, header, payload);
+}
+
+bool ContractionHierarchy::load(const std::string &path, const CSRGraph &graph, ServiceMask service) {
+    std::vector<char> contents;
+    if (!readWholeFile(path, contents)) return false;
+    BinaryReader in{contents.data(), contents.size()};
+
+    //cabecalho
+    char magic[sizeof(MAGIC)];
+    std::uint32_t version, byteOrder, fileService;
+    std::uint64_t fileSource, expectedChecksum;
+    for (char& c : magic) {
+        if (!in.get(c)) return false;
+    }
+    if (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) return false;
+    if (!in.get(version) || version != ROUTE_INDEX_VERSION) return false;
+    if (!in.get(byteOrder) || byteOrder != BYTE_ORDER_MARK) return false;
+    if (!in.get(fileService) || fileService != service) return false;
+    if (!in.get(fileSource) || fileSource != graph.checksum()) return false;
+    if (!in.get(expectedChecksum)) return false;
+    if (fnv1a(in.data + in.position, in.size - in.position) != expectedChecksum) return false;
+
+    std::uint32_t n, numArcs;
+    std::vector<int> fileRank, from, to, line, first, second;
+    std::vector<double> cost;
+    if (!in.get(n) || !in.get(numArcs) || n != (std::uint32_t) graph.getNumStations()) return false;
+    if (!in.getArray(fileRank, n) || !in.getArray(from, numArcs) || !in.getArray(to, numArcs) ||
+        !in.getArray(cost, numArcs) || !in.getArray(line, numArcs) || !in.getArray(first, numArcs) ||
+        !in.getArray(second, numArcs)) return false;
+    if (in.position != in.size) return false;
+
+    //valida tudo antes de alterar a hierarquia
+    std::vector<bool> used(n, false);
+    for (int r : fileRank) {
+        if (r < 0 || r >= (int) n || used[r]) return false;
+        used[r] = true;
+    }
+    for (std::uint32_t a = 0; a < numArcs; a++) {
+        if (from[a] < 0 || from[a] >= (int) n || to[a] < 0 || to[a] >= (int) n) return false;
+        if (line[a] != -1) {
+            if (line[a] < 0 || line[a] >= graph.getNumLines()) return false;
+            if (graph.getTarget(line[a]) != to[a] || graph.getTarget(graph.getReverse(line[a])) != from[a]) return false;
+            continue;
+        }
+        //um atalho passa por uma estacao menos importante do que as duas pontas, por isso desdobra-se sempre
+        if (first[a] < 0 || first[a] >= (int) numArcs || second[a] < 0 || second[a] >= (int) numArcs) return false;
+        int middle = to[first[a]];
+        if (from[first[a]] != from[a] || from[second[a]] != middle || to[second[a]] != to[a]) return false;
+        if (fileRank[middle] >= fileRank[from[a]] || fileRank[middle] >= fileRank[to[a]]) return false;
+    }
+
+    this->service = service;
+    source = fileSource;
+    integerCosts = graph.hasIntegerCapacities();
+    rank = fileRank;
+    arcs.resize(numArcs);
+    for (std::uint32_t a = 0; a < numArcs; a++) {
+        arcs[a] = {from[a], to[a], cost[a], line[a], first[a], second[a]};
+    }
+    buildUpwardGraph();
+    return true;
+}
@@ -0,0 +1,72 @@
+#include <vector>
+#include <algorithm>
+
+#include "../include/GomoryHuTree.h"
+
+GomoryHuTree::GomoryHuTree(const CSRGraph &graph, MaxFlowEngine &engine) {
+    int n = graph.getNumStations();
+    parent.assign(n, 0);
+    weight.assign(n, 0);
+    depth.assign(n, 0);
+    neighbours.assign(n, std::vector<int>());
+    graph.connectedComponents(component);
+
+    if (n == 0) return;
+    parent[0] = -1;
+
+    std::vector<bool> sourceSide;
+    for (int s = 1; s < n; s++) {
+        int t = parent[s];
+        weight[s] = engine.maxFlow(graph, s, t);
+        engine.minCut(graph, t, sourceSide);
+        for (int i = s + 1; i < n; i++) {
+            if (sourceSide[i] && parent[i] == t) parent[i] = s;
+        }
+    }
+
+    //o pai de cada estacao tem sempre um id menor
+    for (int v = 1; v < n; v++) {
+        depth[v] = depth[parent[v]] + 1;
+        neighbours[v].push_back(parent[v]);
+        neighbours[parent[v]].push_back(v);
+    }
+}
+
+double GomoryHuTree::maxFlow(int u, int v) const {
+    if (component[u] != component[v]) return -1;
+
+    double flow = INT32_MAX;
+    while (u != v) {
+        if (depth[u] < depth[v]) std::swap(u, v);
+        flow = std::min(flow, weight[u]);
+        u = parent[u];
+    }
+    return flow;
+}
+
+void GomoryHuTree::maxFlowsFrom(int u, std::vector<double> &flows) const {
+    int n = (int) parent.size();
+    flows.assign(n, -1);
+    std::vector<int> stack;
+    std::vector<bool> visited(n, false);
+
+    flows[u] = INT32_MAX;
+    visited[u] = true;
+    stack.push_back(u);
+
+    while (!stack.empty()) {
+        int v = stack.back();
+        stack.pop_back();
+        for (int w : neighbours[v]) {
+            if (visited[w]) continue;
+            visited[w] = true;
+            flows[w] = std::min(flows[v], parent[w] == v ? weight[w] : weight[v]);
+            stack.push_back(w);
+        }
+    }
+
+    for (int v = 0; v < n; v++) {
+        if (component[v] != component[u]) flows[v] = -1;
+    }
+    flows[u] = -1;
+}
@@ -1,70 +1,192 @@
 #include <vector>
-#include <fstream>
-#include <sstream>
 #include <string>
+#include <string_view>
 #include <queue>
 #include <map>
 #include <unordered_map>
 #include <iostream>
+#include <algorithm>
+#include <climits>
+#include <cmath>
 
 #include "../include/Graph.h"
 #include "../include/constants.h"
-#include "../include/MutablePriorityQueue.h"
+#include "../include/CSVReader.h"
+#include "../include/BinaryDataset.h"
 
-std::vector<Station*> Graph::getStationSet() const {
+Graph::~Graph() {
+    for (auto v : stationSet) {
+        for (auto e : v->getAdj()) {
+            edgePool.destroy(e);
+        }
+        stationPool.destroy(v);
+    }
+}
+
+const std::vector<Station*>& Graph::getStationSet() const {
     return this->stationSet;
 }
 
+CSRGraph& Graph::getSnapshot() {
+    if (snapshotOutdated) {
+        snapshot = CSRGraph(stationSet);
+        snapshotOutdated = false;
+        undirected = snapshot.isUndirected();
+        treeOutdated = true;
+        leavesOutdated = true;
+        context.whatIf.reset();
+        context.paths.reset();
+        routeIndex[0].reset();
+        routeIndex[1].reset();
+    }
+    return snapshot;
+}
+
+const GomoryHuTree *Graph::getGomoryHuTree() {
+    CSRGraph& csr = getSnapshot();
+    if (!csr.isUndirected()) return nullptr;
+    if (treeOutdated) {
+        tree = GomoryHuTree(csr, getEngine(context));
+        treeOutdated = false;
+    }
+    return &tree;
+}
+
+const std::vector<int> &Graph::getLeaves() {
+    getSnapshot();
+    if (leavesOutdated) {
+        leaves.clear();
+        for (auto v : stationSet) {
+            if (v->getAdj().size() == 1) leaves.push_back(v->getId());
+        }
+        leavesOutdated = false;
+    }
+    return leaves;
+}
+
+PathEngine &Graph::getPathEngine() {
+    return getPathEngine(context);
+}
+
+MaxFlowEngine &Graph::getEngine(QueryContext &context) {
+    if (context.engine == nullptr || context.algorithm != algorithm) {
+        context.engine.reset(MaxFlowEngine::create(algorithm));
+        context.algorithm = algorithm;
+    }
+    return *context.engine;
+}
+
+void Graph::refresh(QueryContext &context) {
+    if (context.version == topologyVersion) return;
+    context.paths.reset();
+    context.whatIf.reset();
+    context.version = topologyVersion;
+}
+
+PathEngine &Graph::getPathEngine(QueryContext &context) {
+    CSRGraph& csr = getSnapshot();
+    refresh(context);
+    if (context.paths == nullptr) {
+        context.paths.reset(new PathEngine(csr));
+        context.paths->buildLandmarks(numLandmarks);
+    }
+    return *context.paths;
+}
+
+void Graph::setNumLandmarks(int k) {
+    numLandmarks = k;
+    if (context.paths != nullptr) context.paths->buildLandmarks(k);
+}
+
+ThreadPool &Graph::getThreadPool() {
+    if (pool == nullptr) pool.reset(new ThreadPool());
+    while ((int) workerEngines.size() < pool->size()) {
+        workerEngines.emplace_back(MaxFlowEngine::create(algorithm));
+    }
+    return *pool;
+}
+
+void Graph::setNumThreads(unsigned n) {
+    pool.reset(new ThreadPool(n));
+}
+
+void Graph::setMaxFlowAlgorithm(MaxFlowAlgorithm algorithm) {
+    this->algorithm = algorithm;
+    workerEngines.clear();
+}
+
+std::uint64_t Graph::getTopologyVersion() const {
+    return topologyVersion;
+}
+
+void Graph::setCacheCapacity(std::size_t capacity) {
+    flowCache.setCapacity(capacity);
+    minCostCache.setCapacity(capacity);
+}
+
+CacheStats Graph::getCacheStats() {
+    CacheStats flows = flowCache.getStats(), minCosts = minCostCache.getStats();
+    flows.hits += minCosts.hits;
+    flows.misses += minCosts.misses;
+    flows.entries += minCosts.entries;
+    return flows;
+}
+
+CacheKey Graph::flowKey(int s, int t) const {
+    if (undirected && s > t) std::swap(s, t);
+    return {s, t, SERVICE_ALL, topologyVersion};
+}
+
 bool Graph::addStation(const std::string& name, const std::string& district, const std::string& municipality, const std::string& township, const std::string& line) {
     if (name.empty() || district.empty() || municipality.empty() || township.empty() || line.empty()) return false;
-    stationSet.push_back(new Station(name, district, municipality, township, line));
+    if (stationIndex.find(name) != stationIndex.end()) return false;
+    auto station = stationPool.create(name, district, municipality, township, line, edgePool);
+    stationSet.push_back(station);
+    stationIndex.insert({name, station});
+    snapshotOutdated = true;
+    topologyVersion++;
     return true;
 }
 
 void Graph::readStations() {
-    std::ifstream stationFile(STATIONS_FILE_PATH);
+    CSVReader stationFile(getDatasetPath(STATIONS_FILE_NAME));
 
-    if (stationFile.fail()) return;
+    if (!stationFile.isOpen()) return;
 
-    std::string fileLine, name, district, municipality, township, line;
+    std::vector<std::string_view> fields;
 
-    getline(stationFile, fileLine);
+    //ignora o cabecalho
+    stationFile.readRow(fields);
 
-    while (getline(stationFile, fileLine)) {
-        std::stringstream ss(fileLine);
-        getline(ss, name, ',');
-        getline(ss, district, ',');
-        getline(ss, municipality, ',');
-        getline(ss, township, ',');
-        getline(ss, line, ',');
+    while (stationFile.readRow(fields)) {
+        if (fields.size() != 5) {
+            stationFile.reportError("expected 5 fields, found " + std::to_string(fields.size()));
+            continue;
+        }
 
-        if (findStation(name) != nullptr) continue;
-        if (!addStation(name, district, municipality, township, line)) continue;
+        if (!addStation(std::string(fields[0]), std::string(fields[1]), std::string(fields[2]), std::string(fields[3]), std::string(fields[4]))) continue;
     }
-
-    stationFile.close();
 }
 
 Station *Graph::findStation(const std::string &name) const {
-    for (auto& s : getStationSet()) {
-        if (s->getName() == name) {
-            return s;
-        }
-    }
-    return nullptr;
+    auto it = stationIndex.find(name);
+    if (it == stationIndex.end()) return nullptr;
+    return it->second;
 }
 
-bool Graph::addLine(const std::string &origin, const std::string &dest, const double &capacity, const std::string &service) {
+bool Graph::addLine(const std::string &origin, const std::string &dest, const double &capacity, ServiceMask service) {
     auto s1 = findStation(origin);
     auto s2 = findStation(dest);
     if (s1 == nullptr || s2 == nullptr) {
         return false;
     }
     s1->addLine(s2, capacity, service);
+    snapshotOutdated = true;
+    topologyVersion++;
     return true;
 }
 
-bool Graph::addBidirectionalLine(const std::string &origin, const std::string &dest, const double &capacity, const std::string &service) {
+bool Graph::addBidirectionalLine(const std::string &origin, const std::string &dest, const double &capacity, ServiceMask service) {
     auto s1 = findStation(origin);
     auto s2 = findStation(dest);
     if (s1 == nullptr || s2 == nullptr) {
@@ -74,220 +196,198 @@ bool Graph::addBidirectionalLine(const std::string &origin, const std::string &d
     auto l2 = s2->addLine(s1, capacity, service);
     l1->setReverse(l2);
     l2->setReverse(l1);
+    snapshotOutdated = true;
+    topologyVersion++;
     return true;
 }
 
 bool Graph::removeStation(const Station *station) {
-    std::vector<Station*> &vs = stationSet;
-    int count = 0;
-    for (auto& v : vs) {
-        if(v->getName() == station->getName()) {
-            for (auto& u : vs) {
-                u->removeEdge(station->getName());
-            }
-
-            v->removeOutgoingEdges();
-            vs.erase(vs.begin() + count);
-            delete v;
-            return true;
-        }
-        count++;
-    }
-    return false;
+    if (station == nullptr) return false;
+    auto it = stationIndex.find(station->getName());
+    if (it == stationIndex.end()) return false;
+
+    Station* v = it->second;
+    //so as estacoes com linhas para v precisam de ser alteradas
+    while (!v->getIncoming().empty()) {
+        Edge* e = v->getIncoming().back();
+        e->getOrigin()->deleteEdge(e);
+    }
+
+    v->removeOutgoingEdges();
+    stationSet.erase(std::find(stationSet.begin(), stationSet.end(), v));
+    stationIndex.erase(it);
+    stationPool.destroy(v);
+    snapshotOutdated = true;
+    topologyVersion++;
+    return true;
 }
 
 void Graph::readNetwork() {
-    std::ifstream networkFile(NETWORK_FILE_PATH);
+    CSVReader networkFile(getDatasetPath(NETWORK_FILE_NAME));
 
-    if (networkFile.fail()) return;
+    if (!networkFile.isOpen()) return;
 
-    std::string fileLine, origin, dest, service, capacity;
+    std::vector<std::string_view> fields;
+    std::string origin, dest;
+    double capacity;
 
-    getline(networkFile, fileLine);
+    //ignora o cabecalho
+    networkFile.readRow(fields);
 
-    while (getline(networkFile, fileLine)) {
-        std::stringstream ss(fileLine);
-        getline(ss, origin, ',');
-        getline(ss, dest, ',');
-        getline(ss, capacity, ',');
-        getline(ss, service);
-        addBidirectionalLine(origin, dest, std::stod(capacity), service);
-    }
+    while (networkFile.readRow(fields)) {
+        if (fields.size() != 4) {
+            networkFile.reportError("expected 4 fields, found " + std::to_string(fields.size()));
+            continue;
+        }
+        //o from_chars aceita "nan" e "inf", que estragariam os fluxos maximos
+        if (!parseDouble(fields[2], capacity) || !std::isfinite(capacity) || capacity < 0) {
+            networkFile.reportError("invalid capacity \"" + std::string(fields[2]) + "\"");
+            continue;
+        }
 
+        //as strings sao reutilizadas entre linhas, so os nomes maiores do que os anteriores alocam memoria
+        origin.assign(fields[0]);
+        dest.assign(fields[1]);
+        addBidirectionalLine(origin, dest, capacity, parseService(fields[3]));
+    }
 }
 
-void Graph::fill() {
-    readStations();
-    readNetwork();
+void Graph::setDatasetDirectory(const std::string &directory) {
+    datasetDirectory = directory;
 }
 
-bool Graph::dfs(const std::string &source, const std::string &dest, const std::string& service) {
-    auto s = findStation(source);
-    auto d = findStation(dest);
+std::string Graph::getDatasetPath(const std::string &name) const {
+    if (datasetDirectory.empty() || datasetDirectory.back() == '/') return datasetDirectory + name;
+    return datasetDirectory + "/" + name;
+}
 
-    if (s == nullptr || d == nullptr) {
-        return false;
-    }
+void Graph::fill() {
+    DatasetFingerprint source = fingerprintDataset(getDatasetPath(STATIONS_FILE_NAME), getDatasetPath(NETWORK_FILE_NAME));
 
-    for (auto& station : getStationSet()) {
-        station->setVisited(false);
+    //o ficheiro binario so e usado se tiver sido convertido dos ficheiros csv atuais
+    if (!stationSet.empty() || !readBinaryDataset(*this, getDatasetPath(BINARY_DATASET_NAME), source)) {
+        readStations();
+        readNetwork();
     }
 
-
-    if (service == "ALL") return dfsVisit(s, dest);
-    if (service == "STANDARD") return dfsVisitStandard(s, dest);
-    if (service == "ALFA PENDULAR") return dfsVisitAlfaPendular(s, dest);
-    return false;
+    loadRouteIndex();
 }
 
-bool Graph::dfsVisit(Station *s, const std::string &dest) {
-    s->setVisited(true);
-    if (!s->getAdj().empty()) {
-        for (auto& e : s->getAdj()) {
-            auto neighbor = e->getDest();
-            if (e->getDest()->getName() == dest) return true;
-            if (!neighbor->isVisited()) {
-                if (dfsVisit(neighbor, dest)) return true;
-            }
-        }
-    }
-    return false;
+bool Graph::saveBinaryDataset() const {
+    DatasetFingerprint source = fingerprintDataset(getDatasetPath(STATIONS_FILE_NAME), getDatasetPath(NETWORK_FILE_NAME));
+    return writeBinaryDataset(*this, getDatasetPath(BINARY_DATASET_NAME), source);
 }
 
-bool Graph::dfsVisitStandard(Station *s, const std::string &dest) {
-    s->setVisited(true);
-    if (!s->getAdj().empty()) {
-        for (auto& e : s->getAdj()) {
-            if (e->getService().size()-1 == 8) {
-                auto neighbor = e->getDest();
-                if (e->getDest()->getName() == dest) return true;
-                if (!neighbor->isVisited()) {
-                    if (dfsVisitStandard(neighbor, dest)) return true;
-                }
-            }
-        }
-    }
-    return false;
-}
+void Graph::loadRouteIndex() {
+    const ServiceMask services[2] = {SERVICE_STANDARD, SERVICE_ALFA_PENDULAR};
+    const std::string paths[2] = {getDatasetPath(STANDARD_ROUTE_INDEX_NAME), getDatasetPath(ALFA_PENDULAR_ROUTE_INDEX_NAME)};
+    CSRGraph& csr = getSnapshot();
 
-bool Graph::dfsVisitAlfaPendular(Station *s, const std::string &dest) {
-    s->setVisited(true);
-    if (!s->getAdj().empty()) {
-        for (auto& e : s->getAdj()) {
-            if (e->getService().size()-1 == 13) {
-                auto neighbor = e->getDest();
-                if (e->getDest()->getName() == dest) return true;
-                if (!neighbor->isVisited()) {
-                    if (dfsVisitAlfaPendular(neighbor, dest)) return true;
-                }
-            }
-        }
+    for (int i = 0; i < 2; i++) {
+        routeIndex[i].reset(new ContractionHierarchy());
+        if (!routeIndex[i]->load(paths[i], csr, services[i])) routeIndex[i].reset();
     }
-    return false;
 }
 
-bool Graph::findAugmentingPath(Station *s, Station *t) {
-    for(auto v : stationSet) {
-        v->setVisited(false);
-    }
-    s->setVisited(true);
-    std::queue<Station *> q;
-    q.push(s);
-    while( ! q.empty() && ! t->isVisited()) {
-        auto v = q.front();
-        q.pop();
-        for(auto e: v->getAdj()) {
-            testAndVisit(q, e, e->getDest(), e->getCapacity() - e->getFlow());
-        }
-        for(auto e: v->getIncoming()) {
-            testAndVisit(q, e, e->getOrigin(), e->getFlow());
-        }
-    }
-    return t->isVisited();
-}
+void Graph::buildRouteIndex() {
+    const ServiceMask services[2] = {SERVICE_STANDARD, SERVICE_ALFA_PENDULAR};
+    const std::string paths[2] = {getDatasetPath(STANDARD_ROUTE_INDEX_NAME), getDatasetPath(ALFA_PENDULAR_ROUTE_INDEX_NAME)};
+    CSRGraph& csr = getSnapshot();
 
-double Graph::findMinResidualAlongPath(Station *s, Station *t) {
-    double f = INT32_MAX;
-    for (auto v = t; v != s; ) {
-        auto e = v->getPath();
-        if (e->getDest() == v) {
-            f = std::min(f, e->getCapacity() - e->getFlow());
-            v = e->getOrigin();
-        }
-        else {
-            f = std::min(f, e->getFlow());
-            v = e->getDest();
-        }
+    loadRouteIndex();
+    for (int i = 0; i < 2; i++) {
+        if (routeIndex[i] != nullptr) continue;
+        routeIndex[i].reset(new ContractionHierarchy(csr, services[i]));
+        routeIndex[i]->save(paths[i]);
     }
-    return f;
 }
 
-void Graph::augmentFlowAlongPath(Station *s, Station *t, double f) {
-    for (auto v = t; v != s; ) {
-        auto e = v->getPath();
-        double flow = e->getFlow();
-        if (e->getDest() == v) {
-            e->setFlow(flow + f);
-            v = e->getOrigin();
-        }
-        else {
-            e->setFlow(flow - f);
-            v = e->getDest();
-        }
+bool Graph::dfs(const std::string &source, const std::string &dest, ServiceMask services) {
+    auto s = findStation(source);
+    auto d = findStation(dest);
+
+    if (s == nullptr || d == nullptr) {
+        return false;
     }
+
+    return getSnapshot().dfs(s->getId(), d->getId(), services);
 }
 
 double Graph::maxFlow(const std::string &source, const std::string &target) {
+    return maxFlow(source, target, context);
+}
+
+double Graph::maxFlow(const std::string &source, const std::string &target, QueryContext &context) {
     Station* s = findStation(source);
     Station* t = findStation(target);
     if (s == nullptr || t == nullptr || s == t) {
         return -2;
     }
 
-    if (!dfs(source, target, "ALL")) return -1;
+    CSRGraph& csr = getSnapshot();
+    CacheKey key = flowKey(s->getId(), t->getId());
+    double flow;
+    if (flowCache.find(key, flow)) return flow;
 
-    for (auto v : stationSet) {
-        for (auto e: v->getAdj()) {
-            e->setFlow(0);
-        }
-    }
-
-    while( findAugmentingPath(s, t) ) {
-        double f = findMinResidualAlongPath(s, t);
-        augmentFlowAlongPath(s, t, f);
-    }
-
-    double flow = 0;
-
-    for (auto e : t->getIncoming()) {
-        flow += e->getFlow();
-    }
+    if (!csr.dfs(s->getId(), t->getId(), SERVICE_ALL)) flow = -1;
+    else flow = getEngine(context).maxFlow(csr, s->getId(), t->getId());
 
+    flowCache.insert(key, flow);
     return flow;
 }
 
-void Graph::testAndVisit(std::queue<Station *> &q, Edge *e, Station *w, double residual) {
-    if (! w->isVisited() && residual > 0) {
-        w->setVisited(true);
-        w->setPath(e);
-        q.push(w);
-    }
+std::vector<double> Graph::maxFlows(const std::vector<std::pair<Station*, Station*>> &pairs) {
+    std::vector<double> flows(pairs.size(), -2);
+    CSRGraph& csr = getSnapshot();
+
+    //so compensa construir a arvore se houver mais pares do que estacoes
+    const GomoryHuTree* tree = nullptr;
+    if (!treeOutdated || pairs.size() >= stationSet.size()) tree = getGomoryHuTree();
+
+    getThreadPool().parallelFor((int) pairs.size(), [&](int i, int worker) {
+        Station* s = pairs[i].first;
+        Station* t = pairs[i].second;
+        if (s == nullptr || t == nullptr || s == t) return;
+        if (tree != nullptr) {
+            flows[i] = tree->maxFlow(s->getId(), t->getId());
+            return;
+        }
+
+        //a arvore responde em O(V), so as outras respostas passam pela cache
+        CacheKey key = flowKey(s->getId(), t->getId());
+        if (flowCache.find(key, flows[i])) return;
+        if (!csr.dfs(s->getId(), t->getId(), SERVICE_ALL)) {
+            flows[i] = -1;
+        }
+        else {
+            flows[i] = workerEngines[worker]->maxFlow(csr, s->getId(), t->getId());
+        }
+        flowCache.insert(key, flows[i]);
+    });
+
+    return flows;
 }
 
 std::vector<std::pair<double, std::pair<std::string, std::string>>> Graph::fullMaxFlow() {
     std::map<std::pair<std::string, std::string>, double> map;
     std::vector<std::pair<double, std::pair<std::string, std::string>>> res;
 
-    for (int i = 0; i < getStationSet().size() - 1; i++) {
-        Station* u = getStationSet().at(i);
-        for (int j = i+1; j < getStationSet().size(); j++) {
-            Station* v = getStationSet().at(j);
-            double flow = maxFlow(u->getName(), v->getName());
-            if (flow == -1 || flow == -2) continue;
-            map.insert({{u->getName(), v->getName()}, flow});
+    std::vector<std::pair<Station*, Station*>> pairs;
+
+    int numStations = (int) stationSet.size();
+    for (int i = 0; i < numStations - 1; i++) {
+        for (int j = i+1; j < numStations; j++) {
+            pairs.emplace_back(stationSet.at(i), stationSet.at(j));
         }
     }
 
+    std::vector<double> flows = maxFlows(pairs);
+
+    for (int i = 0; i < (int) pairs.size(); i++) {
+        if (flows[i] == -1 || flows[i] == -2) continue;
+        map.insert({{pairs[i].first->getName(), pairs[i].second->getName()}, flows[i]});
+    }
+
     for (auto& it : map) {
         res.emplace_back(it.second, it.first);
     }
@@ -296,10 +396,13 @@ std::vector<std::pair<double, std::pair<std::string, std::string>>> Graph::fullM
         return p1.first > p2.first;
     });
 
+    //sem estacoes suficientes ou sem pares ligados nao ha nenhum par para devolver
+    if (res.empty()) return res;
+
     double max = res.front().first;
     int counter = 1;
 
-    for (int i = 1; i < res.size(); i++) {
+    for (std::size_t i = 1; i < res.size(); i++) {
         if (res.at(i).first < max) break;
         counter++;
     }
@@ -308,121 +411,143 @@ std::vector<std::pair<double, std::pair<std::string, std::string>>> Graph::fullM
     return final;
 }
 
-std::vector<std::pair<std::string, double>> Graph::topDistricts(int n) {
-    std::unordered_map<std::string, double> map;
+std::vector<std::pair<std::string, double>> Graph::topRegions(GroupBy groupBy, int n, bool inducedSubgraph) {
+    //agrupa as estacoes por regiao
+    std::unordered_map<Symbol, int> groupIndex;
+    std::vector<Symbol> symbols;
+    std::vector<std::vector<Station*>> groups;
+    std::vector<int> groupOf(stationSet.size());
+    CSRGraph& csr = getSnapshot();
 
-    for (auto v : getStationSet()) {
-        map.insert({v->getDistrict(), 0});
-    }
-
-    //calcula flow entre estacoes do mesmo distrito
-    for (auto v : getStationSet()) {
-        for (auto u : getStationSet()) {
-            if (v != u) {
-                if (u->getDistrict() == v->getDistrict()) {
-                    double flow = maxFlow(v->getName(), u->getName()); // O(VE^2)
-                    if (flow == -1 || flow == -2) continue;
-                    map[u->getDistrict()] += flow;
+    for (auto v : stationSet) {
+        auto it = groupIndex.insert({(v->*groupBy)(), (int) groups.size()});
+        if (it.second) {
+            symbols.push_back(it.first->first);
+            groups.emplace_back();
+        }
+        groups[it.first->second].push_back(v);
+        groupOf[v->getId()] = it.first->second;
+    }
+
+    std::vector<double> totals(groups.size(), 0);
+
+    //calcula flow entre estacoes da mesma regiao
+    if (inducedSubgraph) {
+        getThreadPool().parallelFor((int) groups.size(), [&](int g, int worker) {
+            std::vector<int> ids;
+            for (auto v : groups[g]) ids.push_back(v->getId());
+            CSRGraph sub(csr, ids);
+            int k = (int) ids.size();
+
+            if (sub.isUndirected()) {
+                GomoryHuTree subTree(sub, *workerEngines[worker]);
+                std::vector<double> flows;
+                for (int u = 0; u < k; u++) {
+                    subTree.maxFlowsFrom(u, flows);
+                    for (double f : flows) {
+                        if (f > 0) totals[g] += f;
+                    }
+                }
+                return;
+            }
+            for (int u = 0; u < k; u++) {
+                for (int v = 0; v < k; v++) {
+                    if (u == v || !sub.dfs(u, v, SERVICE_ALL)) continue;
+                    totals[g] += workerEngines[worker]->maxFlow(sub, u, v);
                 }
             }
+        });
+    }
+    else {
+        std::vector<std::pair<Station*, Station*>> pairs;
+        for (auto& group : groups) {
+            for (auto v : group) {
+                for (auto u : group) {
+                    if (v != u) pairs.emplace_back(v, u);
+                }
+            }
+        }
+
+        std::vector<double> flows = maxFlows(pairs);
+
+        for (int i = 0; i < (int) pairs.size(); i++) {
+            if (flows[i] == -1 || flows[i] == -2) continue;
+            totals[groupOf[pairs[i].second->getId()]] += flows[i];
         }
     }
 
-    //calcula flow entre estacoes de fora para dentro do distrito
-    for (auto v : getStationSet()) {
-        auto edges = v->getAdj();
-        for (auto e : edges) {
-            Station* neighbor = e->getDest();
-            map[neighbor->getDistrict()] += e->getCapacity();
+    //calcula flow das linhas que chegam a regiao
+    for (auto v : stationSet) {
+        for (auto e : v->getAdj()) {
+            totals[groupOf[e->getDest()->getId()]] += e->getCapacity();
         }
     }
 
     std::vector<std::pair<std::string, double>> res;
 
-    for (auto& it : map) {
-        res.emplace_back(it);
-        std::cout << it.first << " " << it.second << std::endl << std::endl;
+    for (int g = 0; g < (int) groups.size(); g++) {
+        res.emplace_back(SymbolTable::global().getString(symbols[g]), totals[g]);
     }
 
     std::sort(res.begin(), res.end(), [](std::pair<std::string, double>& p1, std::pair<std::string, double>& p2) {return p1.second > p2.second;});
 
-    if (n > res.size()) {
+    if (n < 0 || (std::size_t) n > res.size()) {
         return res;
     }
 
     return {res.begin(), res.begin() + n};
 }
 
+std::vector<std::pair<std::string, double>> Graph::topDistricts(int n) {
+    return topRegions(&Station::getDistrictId, n);
+}
+
 std::vector<std::pair<std::string, double>> Graph::topMunicipalities(int n) {
-    std::unordered_map<std::string, double> map;
+    return topRegions(&Station::getMunicipalityId, n);
+}
 
-    for (auto v : getStationSet()) {
-        map.insert({v->getMunicipality(), 0});
-    }
+std::vector<double> Graph::maxFlowsFromSources(const std::vector<int> &sources, const std::vector<Station*> &targets) {
+    std::vector<double> flows(targets.size(), -2);
+    CSRGraph& csr = getSnapshot();
 
-    //calcula flow entre estacoes do mesmo distrito
-    for (auto v : getStationSet()) {
-        for (auto u : getStationSet()) {
-            if (v != u) {
-                if (u->getMunicipality() == v->getMunicipality()) {
-                    double flow = maxFlow(v->getName(), u->getName());
-                    if (flow == -1 || flow == -2) continue;
-                    map[u->getMunicipality()] += flow;
-                }
-            }
+    getThreadPool().parallelFor((int) targets.size(), [&](int i, int worker) {
+        Station* t = targets[i];
+        if (t == nullptr) return;
+        if (!csr.dfs(sources, t->getId(), SERVICE_ALL)) {
+            flows[i] = -1;
         }
-    }
-
-    //calcula flow entre estacoes de fora para dentro do distrito
-    for (auto v : getStationSet()) {
-        auto edges = v->getAdj();
-        for (auto e : edges) {
-            Station* neighbor = e->getDest();
-            map[neighbor->getMunicipality()] += e->getCapacity();
+        else {
+            flows[i] = workerEngines[worker]->maxFlow(csr, sources, t->getId());
         }
-    }
-
-    std::vector<std::pair<std::string, double>> res;
-
-    for (auto& it : map) {
-        res.emplace_back(it);
-    }
-
-    std::sort(res.begin(), res.end(), [](std::pair<std::string, double>& p1, std::pair<std::string, double>& p2) {return p1.second > p2.second;});
-
-    if (n > res.size()) {
-        return res;
-    }
+    });
 
-    return {res.begin(), res.begin() + n};
+    return flows;
 }
 
 double Graph::maxFlowGridToStation(const std::string &dest) {
+    return maxFlowGridToStation(dest, context);
+}
+
+double Graph::maxFlowGridToStation(const std::string &dest, QueryContext &context) {
     Station* target = findStation(dest);
     if (target == nullptr) {
         return -1;
     }
 
-    if(!addStation("super source", "filler", "filler", "filler", "filler")) return -2;
+    const std::vector<int>& sources = getLeaves();
+    CSRGraph& csr = getSnapshot();
 
-    for (auto& v : getStationSet()) {
-        if (v != target && v->getAdj().size() == 1) {
-            addBidirectionalLine("super source", v->getName(), INT32_MAX, "filler");
-        }
-    }
-
-    double flow = maxFlow("super source", target->getName());
-
-    auto supersource = findStation("super source");
+    if (!csr.dfs(sources, target->getId(), SERVICE_ALL)) return -1;
 
-    removeStation(supersource);
-
-    return flow;
+    return getEngine(context).maxFlow(csr, sources, target->getId());
 }
 
 double Graph::maxFlowSubGraph(const std::vector<std::pair<std::string, std::string>> &linesToRemove, const std::string& origin, const std::string& dest) {
+    return maxFlowSubGraph(linesToRemove, origin, dest, context);
+}
+
+double Graph::maxFlowSubGraph(const std::vector<std::pair<std::string, std::string>> &linesToRemove, const std::string& origin, const std::string& dest, QueryContext &context) {
     std::vector<std::pair<Station*, Station*>> stations;
-    std::vector<std::pair<std::pair<Station*, Station*>, std::pair<double, std::string>>> removedEdges;
 
     for (auto& name : linesToRemove) {
         Station* station1 = findStation(name.first);
@@ -431,29 +556,33 @@ double Graph::maxFlowSubGraph(const std::vector<std::pair<std::string, std::stri
         stations.emplace_back(station1, station2);
     }
 
-    for (auto& p : stations) {
-        Edge* edge = p.first->removeAndStoreEdge(p.second);
-        if (edge == nullptr) continue;
-        removedEdges.push_back({{p.first, p.second}, {edge->getCapacity(), edge->getService()}});
-        Edge* edge2 = p.second->removeAndStoreEdge(p.first);
-        delete edge;
-        delete edge2;
-    }
+    Station* s = findStation(origin);
+    Station* t = findStation(dest);
+    if (s == nullptr || t == nullptr || s == t) return -2;
 
-    double flow = maxFlow(origin, dest);
+    CSRGraph& csr = getSnapshot();
+    refresh(context);
+    std::unique_ptr<IncrementalMaxFlow>& whatIf = context.whatIf;
 
-    for (auto& p : removedEdges) {
-        addBidirectionalLine(p.first.first->getName(), p.first.second->getName(), p.second.first, p.second.second);
+    //o fluxo maximo da rede completa so e calculado quando as estacoes mudam
+    if (whatIf != nullptr && whatIf->getSource() == s->getId() && whatIf->getTarget() == t->getId()) {
+        whatIf->restoreLines();
+    } else {
+        whatIf.reset(new IncrementalMaxFlow(csr, s->getId(), t->getId()));
     }
 
-    return flow;
+    for (auto& p : stations) {
+        whatIf->removeLine(p.first->getId(), p.second->getId());
+    }
+
+    if (!whatIf->isConnected()) return -1;
+
+    return whatIf->getMaxFlow();
 }
 
 std::vector<std::vector<std::pair<Station*, double>>> Graph::topStationsAffected(const std::vector<std::pair<std::string, std::string>> &linesToRemove, const int n, bool& error) {
-    std::map<Station*, double> map;
     std::vector<std::pair<Station*, Station*>> stations;
     std::vector<std::vector<std::pair<Station*, double>>> res;
-    std::vector<std::pair<std::pair<Station*, Station*>, std::pair<double, std::string>>> removedEdges;
 
     for (auto& name : linesToRemove) {
         Station* station1 = findStation(name.first);
@@ -465,26 +594,82 @@ std::vector<std::vector<std::pair<Station*, double>>> Graph::topStationsAffected
         stations.emplace_back(station1, station2);
     }
 
-    //calcula valores maximos
-    for (auto& v : getStationSet()) {
-        map.insert({v, maxFlowGridToStation(v->getName())});
+    CSRGraph& csr = getSnapshot();
+    int numStations = csr.getNumStations();
+
+    //as linhas que nao existem sao ignoradas
+    std::vector<std::pair<int, int>> lines;
+    for (auto& p : stations) {
+        for (auto e : p.first->getAdj()) {
+            if (e->getDest() == p.second) {
+                lines.emplace_back(p.first->getId(), p.second->getId());
+                break;
+            }
+        }
     }
 
+    //a super source e ligada uma unica vez as estacoes com uma so linha, como em maxFlowGridToStation,
+    //e tambem as que ficam com uma so linha quando outra e removida (essas ligacoes comecam excluidas)
+    std::vector<int> sources = getLeaves();
+    std::vector<int> leafLine(numStations, -1);
+    for (int k = 0; k < (int) sources.size(); k++) {
+        leafLine[sources[k]] = k;
+    }
+    int numLeaves = (int) sources.size();
 
-    for (auto& p : stations) {
-        std::vector<std::pair<Station*, double>> aux;
+    std::vector<std::vector<int>> newLeaves(lines.size());
+    for (int i = 0; i < (int) lines.size(); i++) {
+        Station* a = stationSet[lines[i].first];
+        Station* b = stationSet[lines[i].second];
+        bool hasReverse = false;
+        for (auto e : b->getAdj()) {
+            if (e->getDest() == a) hasReverse = true;
+        }
+        if (a->getAdj().size() == 2) newLeaves[i].push_back(a->getId());
+        if (hasReverse && b->getAdj().size() == 2) newLeaves[i].push_back(b->getId());
+        for (int w : newLeaves[i]) {
+            if (leafLine[w] == -1) {
+                leafLine[w] = (int) sources.size();
+                sources.push_back(w);
+            }
+        }
+    }
+
+    CSRGraph grid(csr, sources, INT32_MAX, SERVICE_OTHER);
+    int superSource = numStations;
+    auto sourceLine = [&](int w) { return grid.begin(superSource) + leafLine[w]; };
+
+    std::vector<int> extraLines;
+    for (int k = numLeaves; k < (int) sources.size(); k++) {
+        extraLines.push_back(grid.begin(superSource) + k);
+    }
+
+    //affected[i][v] = diferenca do fluxo da estacao v quando a linha i falha
+    std::vector<std::vector<double>> affected(lines.size(), std::vector<double>(numStations, 0));
+
+    getThreadPool().parallelFor(numStations, [&](int v, int) {
+        std::vector<int> excluded = extraLines;
+        if (leafLine[v] != -1 && leafLine[v] < numLeaves) excluded.push_back(sourceLine(v));
+
+        IncrementalMaxFlow flow(grid, superSource, v, excluded);
+        auto value = [&flow]() { return flow.getMaxFlow() > 0 || flow.isConnected() ? flow.getMaxFlow() : -1; };
+        double maximumFlow = value();
+
+        //o fluxo de cada linha parte do fluxo maximo da rede completa: so as linhas que o transportam obrigam a aumentar
+        for (int i = 0; i < (int) lines.size(); i++) {
+            flow.removeLine(lines[i].first, lines[i].second);
+            for (int w : newLeaves[i]) {
+                if (w != v) flow.includeLine(sourceLine(w));
+            }
+            affected[i][v] = std::abs(maximumFlow - value());
+            flow.restoreLines();
+        }
+    });
 
-        //remove aresta do grafo
-        Edge* edge = p.first->removeAndStoreEdge(p.second);
-        if (edge == nullptr) continue;
-        removedEdges.push_back({{p.first, p.second}, {edge->getCapacity(), edge->getService()}});
-        Edge* edge2 = p.second->removeAndStoreEdge(p.first);
-        delete edge;
-        delete edge2;
-
-        for (auto& v : getStationSet()) {
-            double maximumFlow = map[v];
-            aux.emplace_back(v, std::abs(maximumFlow - maxFlowGridToStation(v->getName())));
+    for (auto& line : affected) {
+        std::vector<std::pair<Station*, double>> aux;
+        for (auto v : stationSet) {
+            aux.emplace_back(v, line[v->getId()]);
         }
 
         //ordena elementos
@@ -503,18 +688,16 @@ std::vector<std::vector<std::pair<Station*, double>>> Graph::topStationsAffected
             std::vector<std::pair<Station*, double>> final(aux.begin(), aux.begin() + n);
             res.push_back(final);
         }
-
-        for (auto& pair : removedEdges) {
-            addBidirectionalLine(pair.first.first->getName(), pair.first.second->getName(), pair.second.first, pair.second.second);
-        }
-
-        aux.clear();
     }
 
     return res;
 }
 
 std::pair<double, double> Graph::maxFlowMinCost(const std::string &origin, const std::string &dest, std::string& service) {
+    return maxFlowMinCost(origin, dest, service, context);
+}
+
+std::pair<double, double> Graph::maxFlowMinCost(const std::string &origin, const std::string &dest, std::string& service, QueryContext &context) {
     auto source = findStation(origin);
     auto target = findStation(dest);
 
@@ -522,21 +705,52 @@ std::pair<double, double> Graph::maxFlowMinCost(const std::string &origin, const
         return {-2, -2};
     }
 
+    getSnapshot();
+    CacheKey key{source->getId(), target->getId(), SERVICE_ALL, topologyVersion};
+    MinCostResult result;
+    if (minCostCache.find(key, result)) {
+        if (result.costAndTrains.first != -1) service = result.service;
+        return result.costAndTrains;
+    }
+
+    result.costAndTrains = computeMaxFlowMinCost(source->getId(), target->getId(), result.service, context);
+    minCostCache.insert(key, result);
+    if (result.costAndTrains.first != -1) service = result.service;
+    return result.costAndTrains;
+}
+
+std::pair<double, double> Graph::computeMaxFlowMinCost(int s, int t, std::string &service, QueryContext &context) {
+    CSRGraph& csr = getSnapshot();
+    std::vector<int> path;
+
     bool existsPath = false;
     int alfaPaths, standardPaths;
     double alfaCost, standardCost, standardTrains, alfaTrains;
     alfaCost = standardCost = INT_MAX;
 
-    if (dfs(source->getName(), target->getName(), "ALFA PENDULAR")) {
-        dijkstra(source, target, "ALFA PENDULAR");
-        alfaTrains = calculateCost(source, target, alfaPaths);
+    //usa a hierarquia do servico se estiver carregada
+    auto findPath = [&](ServiceMask service, int index) {
+        if (routeIndex[index] != nullptr) return routeIndex[index]->shortestPath(s, t, path, context.routeSearch[index]);
+        return getPathEngine(context).shortestPath(s, t, service, path);
+    };
+
+    //o numero de comboios e a menor capacidade do caminho
+    auto trains = [&csr, &path]() {
+        double flow = INT_MAX;
+        for (int e : path) flow = std::min(flow, csr.getCapacity(e));
+        return flow;
+    };
+
+    if (findPath(SERVICE_ALFA_PENDULAR, 1)) {
+        alfaTrains = trains();
+        alfaPaths = (int) path.size();
         alfaCost = alfaTrains * ALFA_PENDULAR_COST * alfaPaths;
         existsPath = true;
     }
 
-    if (dfs(source->getName(), target->getName(), "STANDARD")) {
-        dijkstra(source, target, "STANDARD");
-        standardTrains = calculateCost(source, target, standardPaths);
+    if (findPath(SERVICE_STANDARD, 0)) {
+        standardTrains = trains();
+        standardPaths = (int) path.size();
         standardCost = standardTrains * STANDARD_COST * standardPaths;
         existsPath = true;
     }
@@ -556,58 +770,3 @@ std::pair<double, double> Graph::maxFlowMinCost(const std::string &origin, const
     service = "STANDARD";
     return {standardCost, standardTrains};
 }
-
-double Graph::calculateCost(Station *origin, Station *dest, int& nPath) const {
-    double maxFlow, cost;
-    nPath = 0;
-    maxFlow = INT_MAX;
-    auto e = dest->getPath();
-
-    while (true) {
-
-        if (e != nullptr) {
-            cost = e->getCapacity();
-            if (cost < maxFlow) maxFlow = cost;
-            e = e->getOrigin()->getPath();
-            nPath++;
-        }
-        else {
-            break;
-        }
-    }
-    return maxFlow;
-}
-
-void Graph::dijkstra(Station* origin, Station* dest, const std::string& service) {
-    for (auto& s : getStationSet()) {
-        s->setVisited(false);
-        s->setPath(nullptr);
-        s->setCost(INT32_MAX);
-    }
-
-    origin->setCost(0);
-
-    MutablePriorityQueue<Station> q;
-
-    for (auto& v : getStationSet()) {
-        q.insert(v);
-    }
-
-    while (!q.empty()) {
-        auto u = q.extractMin();
-        u->setVisited(true);
-
-        if (u == dest) return;
-
-        for (auto& e : u->getAdj()) {
-            if (e->getService().size() - 1 == service.size()) {
-                Station* neighbor = e->getDest();
-                if (!neighbor->isVisited() && e->getCapacity() + u->getCost() < neighbor->getCost()) {
-                    neighbor->setPath(e);
-                    neighbor->setCost(e->getCapacity() + u->getCost());
-                    q.decreaseKey(neighbor);
-                }
-            }
-        }
-    }
-}
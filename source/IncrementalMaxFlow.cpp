@@ -0,0 +1,191 @@
+#include <vector>
+#include <limits>
+#include <algorithm>
+
+#include "../include/IncrementalMaxFlow.h"
+
+/**
+ * @brief Marks a step of an augmenting path through the virtual line from the final station to the origin station.
+ */
+static const int VIRTUAL_FORWARD = -2;
+
+/**
+ * @brief Marks a step of an augmenting path through the virtual line from the origin station to the final station.
+ */
+static const int VIRTUAL_BACKWARD = -3;
+
+IncrementalMaxFlow::IncrementalMaxFlow(const CSRGraph &graph, int s, int t, const std::vector<int>& excludedLines): graph(&graph), s(s), t(t), excluded(excludedLines) {
+    flow.assign(graph.getNumLines(), 0);
+    active.assign(graph.getNumLines(), true);
+    for (int e : excluded) {
+        active[e] = active[graph.getReverse(e)] = false;
+    }
+    hasChanges = false;
+    flowChanged = false;
+    value = 0;
+    value = augment(s, t, std::numeric_limits<double>::max(), false);
+}
+
+int IncrementalMaxFlow::getSource() const {
+    return s;
+}
+
+int IncrementalMaxFlow::getTarget() const {
+    return t;
+}
+
+double IncrementalMaxFlow::getMaxFlow() const {
+    return value;
+}
+
+bool IncrementalMaxFlow::removeLine(int u, int v) {
+    int e = findLine(u, v);
+    if (e == -1) return false;
+
+    bool oneWay = graph->getService(graph->getReverse(e)) == SERVICE_NONE;
+    if (deactivate(e)) flowChanged = true;
+
+    //uma linha sem reverse nao remove a linha no sentido contrario, por isso procuramos a primeira
+    if (oneWay) {
+        int r = findLine(v, u);
+        if (r != -1 && deactivate(r)) flowChanged = true;
+    }
+
+    hasChanges = true;
+    return true;
+}
+
+void IncrementalMaxFlow::includeLine(int e) {
+    active[e] = active[graph->getReverse(e)] = true;
+    included.push_back(e);
+    hasChanges = true;
+    value += augment(s, t, std::numeric_limits<double>::max(), false);
+}
+
+void IncrementalMaxFlow::restoreLines() {
+    if (!hasChanges) return;
+
+    //as linhas incluidas voltam a sair, cancelando o fluxo que transportavam
+    for (int e : included) {
+        if (deactivate(e)) flowChanged = true;
+    }
+    included.clear();
+
+    std::fill(active.begin(), active.end(), true);
+    for (int e : excluded) {
+        active[e] = active[graph->getReverse(e)] = false;
+    }
+    hasChanges = false;
+
+    //o fluxo so diminuiu se alguma linha removida o transportava
+    if (!flowChanged) return;
+    flowChanged = false;
+    value += augment(s, t, std::numeric_limits<double>::max(), false);
+}
+
+bool IncrementalMaxFlow::isConnected() const {
+    std::vector<bool> seen(graph->getNumStations(), false);
+    std::vector<int> stack;
+    seen[s] = true;
+    stack.push_back(s);
+    while (!stack.empty()) {
+        int v = stack.back();
+        stack.pop_back();
+        for (int e = graph->begin(v); e < graph->end(v); e++) {
+            if (!active[e] || graph->getService(e) == SERVICE_NONE) continue;
+            int w = graph->getTarget(e);
+            if (w == t) return true;
+            if (!seen[w]) {
+                seen[w] = true;
+                stack.push_back(w);
+            }
+        }
+    }
+    return false;
+}
+
+int IncrementalMaxFlow::findLine(int u, int v) const {
+    for (int e = graph->begin(u); e < graph->end(u); e++) {
+        if (graph->getTarget(e) == v && active[e] && graph->getService(e) != SERVICE_NONE) return e;
+    }
+    return -1;
+}
+
+bool IncrementalMaxFlow::deactivate(int e) {
+    int r = graph->getReverse(e);
+    int x = flow[e] > 0 ? e : r;
+    double f = std::max(flow[x], 0.0);
+    int a = graph->getTarget(graph->getReverse(x));
+    int b = graph->getTarget(x);
+
+    flow[e] = flow[r] = 0;
+    active[e] = active[r] = false;
+
+    if (f <= 0) return false;
+
+    //a fica com f a mais e b com f a menos: com a linha virtual t->s o fluxo e uma circulacao, por isso existe sempre
+    //um caminho residual de a para b que o corrige (podendo diminuir o fluxo maximo)
+    augment(a, b, f, true);
+
+    //o fluxo cancelado pode ter passado a ter outro caminho
+    value += augment(s, t, std::numeric_limits<double>::max(), false);
+    return true;
+}
+
+bool IncrementalMaxFlow::findAugmentingPath(int from, int to, bool virtualLine) {
+    visited.assign(graph->getNumStations(), false);
+    path.resize(graph->getNumStations());
+    queue.clear();
+    visited[from] = true;
+    queue.push_back(from);
+    for (std::size_t head = 0; head < queue.size() && !visited[to]; head++) {
+        int v = queue[head];
+        for (int e = graph->begin(v); e < graph->end(v); e++) {
+            int w = graph->getTarget(e);
+            if (!visited[w] && residual(e) > 0) {
+                visited[w] = true;
+                path[w] = e;
+                queue.push_back(w);
+            }
+        }
+        if (virtualLine && v == t && !visited[s]) {
+            visited[s] = true;
+            path[s] = VIRTUAL_FORWARD;
+            queue.push_back(s);
+        }
+        if (virtualLine && v == s && !visited[t] && value > 0) {
+            visited[t] = true;
+            path[t] = VIRTUAL_BACKWARD;
+            queue.push_back(t);
+        }
+    }
+    return visited[to];
+}
+
+double IncrementalMaxFlow::augment(int from, int to, double limit, bool virtualLine) {
+    double sent = 0;
+
+    while (sent < limit && findAugmentingPath(from, to, virtualLine)) {
+        double f = limit - sent;
+        for (int v = to; v != from; ) {
+            int e = path[v];
+            if (e == VIRTUAL_FORWARD) { v = t; continue; }
+            if (e == VIRTUAL_BACKWARD) { f = std::min(f, value); v = s; continue; }
+            f = std::min(f, residual(e));
+            v = graph->getTarget(graph->getReverse(e));
+        }
+
+        for (int v = to; v != from; ) {
+            int e = path[v];
+            if (e == VIRTUAL_FORWARD) { value += f; v = t; continue; }
+            if (e == VIRTUAL_BACKWARD) { value -= f; v = s; continue; }
+            flow[e] += f;
+            flow[graph->getReverse(e)] -= f;
+            v = graph->getTarget(graph->getReverse(e));
+        }
+
+        sent += f;
+    }
+
+    return sent;
+}
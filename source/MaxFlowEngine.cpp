@@ -0,0 +1,319 @@
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <limits>
+#include <climits>
+
+#include "../include/MaxFlowEngine.h"
+
+bool parseMaxFlowAlgorithm(const std::string &name, MaxFlowAlgorithm &algorithm) {
+    if (name == "edmonds-karp") algorithm = EDMONDS_KARP;
+    else if (name == "dinic") algorithm = DINIC;
+    else if (name == "push-relabel") algorithm = PUSH_RELABEL;
+    else return false;
+    return true;
+}
+
+/************************* MaxFlowEngine  **************************/
+
+MaxFlowEngine *MaxFlowEngine::create(MaxFlowAlgorithm algorithm) {
+    switch (algorithm) {
+        case DINIC: return new Dinic();
+        case PUSH_RELABEL: return new PushRelabel();
+        default: return new EdmondsKarp();
+    }
+}
+
+double MaxFlowEngine::maxFlow(const CSRGraph &graph, int s, int t) {
+    single.assign(1, s);
+    return maxFlow(graph, single, t);
+}
+
+void MaxFlowEngine::markSources(const CSRGraph &graph, const std::vector<int> &sources, int t) {
+    isSource.assign(graph.getNumStations(), false);
+    for (int s : sources) {
+        isSource[s] = true;
+    }
+    isSource[t] = false;
+}
+
+void MaxFlowEngine::minCut(const CSRGraph &graph, int t, std::vector<bool> &sourceSide) const {
+    std::vector<int> queue;
+    sourceSide.assign(graph.getNumStations(), true);
+    sourceSide[t] = false;
+    queue.push_back(t);
+
+    for (std::size_t head = 0; head < queue.size(); head++) {
+        int w = queue[head];
+        for (int e = graph.begin(w); e < graph.end(w); e++) {
+            int v = graph.getTarget(e);
+            if (sourceSide[v] && residual(graph, graph.getReverse(e)) > 0) {
+                sourceSide[v] = false;
+                queue.push_back(v);
+            }
+        }
+    }
+}
+
+/************************* EdmondsKarp  **************************/
+
+double EdmondsKarp::maxFlow(const CSRGraph &graph, const std::vector<int> &sources, int t) {
+    flow.assign(graph.getNumLines(), 0);
+    markSources(graph, sources, t);
+
+    double total = 0;
+
+    while (findAugmentingPath(graph, sources, t)) {
+        double f = findMinResidualAlongPath(graph, t);
+        augmentFlowAlongPath(graph, t, f);
+        total += f;
+    }
+
+    return total;
+}
+
+bool EdmondsKarp::findAugmentingPath(const CSRGraph &graph, const std::vector<int> &sources, int t) {
+    visited.assign(graph.getNumStations(), false);
+    path.resize(graph.getNumStations());
+    queue.clear();
+    for (int s : sources) {
+        if (!isSource[s] || visited[s]) continue;
+        visited[s] = true;
+        queue.push_back(s);
+    }
+    for (std::size_t head = 0; head < queue.size() && !visited[t]; head++) {
+        int v = queue[head];
+        for (int e = graph.begin(v); e < graph.end(v); e++) {
+            int w = graph.getTarget(e);
+            if (!visited[w] && residual(graph, e) > 0) {
+                visited[w] = true;
+                path[w] = e;
+                queue.push_back(w);
+            }
+        }
+    }
+    return visited[t];
+}
+
+double EdmondsKarp::findMinResidualAlongPath(const CSRGraph &graph, int t) const {
+    double f = INT32_MAX;
+    for (int v = t; !isSource[v]; v = graph.getTarget(graph.getReverse(path[v]))) {
+        f = std::min(f, residual(graph, path[v]));
+    }
+    return f;
+}
+
+void EdmondsKarp::augmentFlowAlongPath(const CSRGraph &graph, int t, double f) {
+    for (int v = t; !isSource[v]; v = graph.getTarget(graph.getReverse(path[v]))) {
+        push(graph, path[v], f);
+    }
+}
+
+/************************* Dinic  **************************/
+
+double Dinic::maxFlow(const CSRGraph &graph, const std::vector<int> &sources, int t) {
+    flow.assign(graph.getNumLines(), 0);
+    current.resize(graph.getNumStations());
+    markSources(graph, sources, t);
+
+    double total = 0;
+
+    while (buildLevels(graph, sources, t)) {
+        for (int v = 0; v < graph.getNumStations(); v++) {
+            current[v] = graph.begin(v);
+        }
+        for (int s : sources) {
+            if (!isSource[s]) continue;
+            double f;
+            while ((f = sendFlow(graph, s, t)) > 0) {
+                total += f;
+            }
+        }
+    }
+
+    return total;
+}
+
+bool Dinic::buildLevels(const CSRGraph &graph, const std::vector<int> &sources, int t) {
+    level.assign(graph.getNumStations(), -1);
+    queue.clear();
+    for (int s : sources) {
+        if (!isSource[s] || level[s] == 0) continue;
+        level[s] = 0;
+        queue.push_back(s);
+    }
+    for (std::size_t head = 0; head < queue.size(); head++) {
+        int v = queue[head];
+        for (int e = graph.begin(v); e < graph.end(v); e++) {
+            int w = graph.getTarget(e);
+            if (level[w] == -1 && residual(graph, e) > 0) {
+                level[w] = level[v] + 1;
+                queue.push_back(w);
+            }
+        }
+    }
+    return level[t] != -1;
+}
+
+double Dinic::sendFlow(const CSRGraph &graph, int s, int t) {
+    path.clear();
+    int v = s;
+    while (v != t) {
+        int& e = current[v];
+        while (e < graph.end(v) && (level[graph.getTarget(e)] != level[v] + 1 || residual(graph, e) <= 0)) e++;
+        if (e < graph.end(v)) {
+            path.push_back(e);
+            v = graph.getTarget(e);
+            continue;
+        }
+        //sem saida: volta a estacao anterior e passa a linha seguinte
+        if (path.empty()) return 0;
+        v = graph.getTarget(graph.getReverse(path.back()));
+        path.pop_back();
+        current[v]++;
+    }
+
+    double f = std::numeric_limits<double>::max();
+    for (int line : path) {
+        f = std::min(f, residual(graph, line));
+    }
+    for (int line : path) {
+        push(graph, line, f);
+    }
+    return f;
+}
+
+/************************* PushRelabel  **************************/
+
+double PushRelabel::maxFlow(const CSRGraph &graph, const std::vector<int> &sources, int t) {
+    int n = graph.getNumStations();
+    flow.assign(graph.getNumLines(), 0);
+    excess.assign(n, 0);
+    height.assign(n, n);
+    current.resize(n);
+    markSources(graph, sources, t);
+
+    globalRelabel(graph, t);
+
+    //satura todas as arestas que saem das origens
+    for (int s = 0; s < n; s++) {
+        if (!isSource[s]) continue;
+        for (int e = graph.begin(s); e < graph.end(s); e++) {
+            int w = graph.getTarget(e);
+            double r = residual(graph, e);
+            if (r <= 0 || isSource[w]) continue;
+            bool wasActive = excess[w] > 0;
+            push(graph, e, r);
+            excess[s] -= r;
+            excess[w] += r;
+            if (!wasActive && w != t) activate(w);
+        }
+    }
+
+    int relabels = 0;
+    while (highest >= 0) {
+        if (active[highest].empty()) {
+            highest--;
+            continue;
+        }
+        int v = active[highest].back();
+        active[highest].pop_back();
+        if (height[v] != highest || excess[v] <= 0) continue;
+
+        relabels += discharge(graph, v, t);
+
+        if (relabels > n) {
+            globalRelabel(graph, t);
+            relabels = 0;
+        }
+    }
+
+    return excess[t];
+}
+
+void PushRelabel::globalRelabel(const CSRGraph &graph, int t) {
+    int n = graph.getNumStations();
+    std::vector<int> queue;
+    std::fill(height.begin(), height.end(), n);
+    height[t] = 0;
+    queue.push_back(t);
+
+    for (std::size_t head = 0; head < queue.size(); head++) {
+        int w = queue[head];
+        for (int e = graph.begin(w); e < graph.end(w); e++) {
+            int v = graph.getTarget(e);
+            if (isSource[v] || height[v] != n) continue;
+            if (residual(graph, graph.getReverse(e)) > 0) {
+                height[v] = height[w] + 1;
+                queue.push_back(v);
+            }
+        }
+    }
+
+    count.assign(n + 1, 0);
+    active.assign(n, std::vector<int>());
+    highest = -1;
+    for (int v = 0; v < n; v++) {
+        count[height[v]]++;
+        current[v] = graph.begin(v);
+        if (!isSource[v] && v != t && excess[v] > 0) activate(v);
+    }
+}
+
+void PushRelabel::activate(int v) {
+    if (height[v] >= (int) active.size()) return;
+    active[height[v]].push_back(v);
+    highest = std::max(highest, height[v]);
+}
+
+int PushRelabel::discharge(const CSRGraph &graph, int v, int t) {
+    int n = graph.getNumStations();
+    int relabels = 0;
+
+    while (excess[v] > 0) {
+        if (current[v] == graph.end(v)) {
+            //relabel
+            int old = height[v];
+            int minHeight = n;
+            for (int e = graph.begin(v); e < graph.end(v); e++) {
+                if (residual(graph, e) > 0) minHeight = std::min(minHeight, height[graph.getTarget(e)] + 1);
+            }
+            relabels++;
+            count[old]--;
+            height[v] = std::min(minHeight, n);
+            count[height[v]]++;
+            current[v] = graph.begin(v);
+
+            //gap: nenhuma estacao acima da altura antiga consegue chegar ao destino
+            if (count[old] == 0) {
+                for (int u = 0; u < n; u++) {
+                    if (height[u] > old && height[u] < n) {
+                        count[height[u]]--;
+                        height[u] = n;
+                        count[n]++;
+                    }
+                }
+            }
+
+            if (height[v] >= n) break;
+            continue;
+        }
+
+        int e = current[v];
+        int w = graph.getTarget(e);
+        double r = residual(graph, e);
+        if (r > 0 && height[v] == height[w] + 1) {
+            double d = std::min(excess[v], r);
+            bool wasActive = excess[w] > 0;
+            push(graph, e, d);
+            excess[v] -= d;
+            excess[w] += d;
+            if (!wasActive && !isSource[w] && w != t) activate(w);
+        }
+        else {
+            current[v]++;
+        }
+    }
+
+    return relabels;
+}
@@ -0,0 +1,329 @@
+#include <cmath>
+#include <random>
+#include <cstdint>
+#include <algorithm>
+#include <fstream>
+#include <filesystem>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../include/NetworkGenerator.h"
+#include "../include/Graph.h"
+#include "../include/constants.h"
+
+/**
+ * @brief The side of the cells used to find nearby stations, in units of the distance between consecutive stations.
+ */
+static const double CELL_SIZE = 1.5;
+
+/**
+ * @brief The number of stations of each cell that are considered for a line between nearby stations.
+ */
+static const std::size_t MAX_CANDIDATES = 16;
+
+/**
+ * @brief The most a line turns at each station (in radians), so the lines are not straight.
+ */
+static const double MAX_TURN = 0.3;
+
+/**
+ * @brief Draws an integer in [0, n) from the generator.
+ *
+ * @note The std distributions are not used: their algorithms are left to each standard library, while the sequence of
+ * std::mt19937 is fixed, so the same seed gives the same network with any compiler.
+ */
+static int uniformInt(std::mt19937& rng, int n) {
+    return (int) ((std::uint64_t) rng() * (std::uint64_t) n >> 32);
+}
+
+/**
+ * @brief Draws a real number in [0, 1) from the generator, with 27 random bits.
+ */
+static double uniformReal(std::mt19937& rng) {
+    return (double) (rng() >> 5) * (1.0 / 134217728.0);
+}
+
+/**
+ * @brief Draws the number of failed trials before the first success, each trial succeeding with probability p, by
+ * inverting the cumulative distribution.
+ */
+static int geometric(std::mt19937& rng, double p) {
+    if (p >= 1) return 0;
+    return (int) std::floor(std::log(1 - uniformReal(rng)) / std::log(1 - p));
+}
+
+bool parseTopology(const std::string &name, Topology &topology) {
+    if (name == "tree") topology = TOPOLOGY_TREE;
+    else if (name == "mesh") topology = TOPOLOGY_MESH;
+    else if (name == "ring") topology = TOPOLOGY_RING;
+    else return false;
+    return true;
+}
+
+bool parseCapacityDistribution(const std::string &name, CapacityDistribution &distribution) {
+    if (name == "uniform") distribution = CAPACITY_UNIFORM;
+    else if (name == "geometric") distribution = CAPACITY_GEOMETRIC;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief Gets a key for the pair of stations of a segment, the same in both directions.
+ */
+static long long segmentKey(int a, int b) {
+    if (a > b) std::swap(a, b);
+    return (long long) a << 32 | (unsigned) b;
+}
+
+/**
+ * @brief Gets the key of the cell of a position.
+ */
+static long long cellKey(long long x, long long y) {
+    return x << 32 ^ (y & 0xFFFFFFFFLL);
+}
+
+NetworkGenerator::NetworkGenerator(const GeneratorOptions &options) {
+    layLines(options);
+    if (options.topology == TOPOLOGY_MESH) addMeshSegments(options);
+    assignRegions(options);
+}
+
+void NetworkGenerator::layLines(const GeneratorOptions &options) {
+    const double pi = std::acos(-1.0);
+    int numStations = std::max(2, options.numStations);
+    std::mt19937 rng(options.seed);
+
+    //cada linha tem a estacao onde comeca mais 1 + g estacoes novas, em media meanLineLength estacoes
+    double meanLength = std::max(2.0, options.meanLineLength);
+    double extraProbability = 1.0 / (meanLength - 1.0);
+    double alfaPendularRatio = std::min(1.0, std::max(0.0, options.alfaPendularRatio));
+
+    int minCapacity = std::max(1, options.minCapacity);
+    int step = std::max(1, options.capacityStep);
+    int numCapacities = std::max(1, (options.maxCapacity - minCapacity) / step + 1);
+    auto capacity = [&]() {
+        if (options.capacityDistribution == CAPACITY_UNIFORM) return minCapacity + uniformInt(rng, numCapacities) * step;
+        int k;
+        do k = geometric(rng, 0.5); while (k >= numCapacities);
+        return minCapacity + k * step;
+    };
+
+    stations.reserve(numStations);
+    positions.reserve(numStations);
+    lineIds.reserve(numStations);
+    for (int line = 1; (int) stations.size() < numStations; line++) {
+        std::string lineName = "Line " + std::to_string(line);
+        int segmentCapacity = capacity();
+        ServiceMask service = uniformReal(rng) < alfaPendularRatio ? SERVICE_ALFA_PENDULAR : SERVICE_STANDARD;
+
+        //a primeira linha comeca na origem, as outras numa estacao ja existente
+        int first;
+        if (stations.empty()) {
+            stations.push_back({"Station 1", "", "", "", lineName});
+            positions.emplace_back(0, 0);
+            lineIds.push_back(line);
+            first = 0;
+        }
+        else {
+            first = uniformInt(rng, (int) stations.size());
+        }
+
+        int length = std::min(1 + geometric(rng, extraProbability), numStations - (int) stations.size());
+        double angle = 2 * pi * uniformReal(rng);
+        //nos aneis a linha da uma volta completa e fecha na primeira estacao
+        double ringTurn = 2 * pi / (length + 1);
+        auto position = positions[first];
+        int previous = first;
+        for (int i = 0; i < length; i++) {
+            angle += options.topology == TOPOLOGY_RING ? ringTurn : MAX_TURN * (2 * uniformReal(rng) - 1);
+            position.first += std::cos(angle);
+            position.second += std::sin(angle);
+            int station = (int) stations.size();
+            stations.push_back({"Station " + std::to_string(station + 1), "", "", "", lineName});
+            positions.push_back(position);
+            lineIds.push_back(line);
+            segments.push_back({previous, station, segmentCapacity, service});
+            previous = station;
+        }
+        if (options.topology == TOPOLOGY_RING && length >= 2) {
+            segments.push_back({previous, first, segmentCapacity, service});
+        }
+    }
+}
+
+void NetworkGenerator::addMeshSegments(const GeneratorOptions &options) {
+    int numStations = (int) stations.size();
+    std::mt19937 rng(options.seed ^ 0x5bd1e995u);
+    double alfaPendularRatio = std::min(1.0, std::max(0.0, options.alfaPendularRatio));
+
+    std::unordered_set<long long> linked;
+    for (auto& segment : segments) linked.insert(segmentKey(segment.origin, segment.dest));
+
+    //as estacoes sao agrupadas em celulas para encontrar as mais proximas, com a linha e a posicao de cada uma
+    //guardadas juntas, porque as estacoes de uma celula estao espalhadas pela rede
+    struct CellStation {
+        int id;
+        int line;
+        double x, y;
+    };
+    std::unordered_map<long long, std::vector<CellStation>> cells;
+    auto cellOf = [&](int v) {
+        return std::make_pair((long long) std::floor(positions[v].first / CELL_SIZE),
+                              (long long) std::floor(positions[v].second / CELL_SIZE));
+    };
+    for (int v = 0; v < numStations; v++) {
+        auto cell = cellOf(v);
+        cells[cellKey(cell.first, cell.second)].push_back({v, lineIds[v], positions[v].first, positions[v].second});
+    }
+
+    //a capacidade de uma ligacao entre linhas e a menor das capacidades das linhas das duas estacoes
+    std::vector<int> lineCapacity(numStations, std::max(1, options.minCapacity));
+    for (auto& segment : segments) {
+        lineCapacity[segment.dest] = segment.capacity;
+    }
+
+    //uma estacao sem vizinhas livres nao tem ligacao, por isso o numero de tentativas e limitado
+    int numExtra = (int) std::lround(std::max(0.0, options.meshRatio) * numStations);
+    for (int attempts = 4 * numExtra; numExtra > 0 && attempts > 0; attempts--) {
+        int u = uniformInt(rng, numStations);
+        auto cell = cellOf(u);
+        int best = -1;
+        double bestDistance = 0;
+        for (long long dx = -1; dx <= 1; dx++) {
+            for (long long dy = -1; dy <= 1; dy++) {
+                auto it = cells.find(cellKey(cell.first + dx, cell.second + dy));
+                if (it == cells.end()) continue;
+                //as celulas ficam mais densas com o tamanho da rede, so algumas estacoes de cada uma sao vistas
+                const std::vector<CellStation>& cellStations = it->second;
+                std::size_t start = rng() % cellStations.size();
+                std::size_t count = std::min(cellStations.size(), MAX_CANDIDATES);
+                for (std::size_t k = 0; k < count; k++) {
+                    const CellStation& candidate = cellStations[(start + k) % cellStations.size()];
+                    if (candidate.line == lineIds[u]) continue;
+                    double x = candidate.x - positions[u].first, y = candidate.y - positions[u].second;
+                    if (best != -1 && x * x + y * y >= bestDistance) continue;
+                    if (linked.count(segmentKey(u, candidate.id))) continue;
+                    best = candidate.id;
+                    bestDistance = x * x + y * y;
+                }
+            }
+        }
+        if (best == -1) continue;
+        linked.insert(segmentKey(u, best));
+        ServiceMask service = uniformReal(rng) < alfaPendularRatio ? SERVICE_ALFA_PENDULAR : SERVICE_STANDARD;
+        segments.push_back({u, best, std::min(lineCapacity[u], lineCapacity[best]), service});
+        numExtra--;
+    }
+}
+
+/**
+ * @brief Splits stations in parts of (almost) the same size, cutting along the longest side of their bounding box
+ * each time, so every part is a compact region.
+ *
+ * @param ids The stations.
+ * @param numParts The number of parts. At most the number of stations.
+ * @param positions The position of each station.
+ * @param parts The parts. Each part is appended at the end.
+ */
+static void splitRegion(std::vector<int> ids, int numParts, const std::vector<std::pair<double, double>>& positions,
+                        std::vector<std::vector<int>>& parts) {
+    if (numParts <= 1 || ids.size() <= 1) {
+        parts.push_back(std::move(ids));
+        return;
+    }
+    double minX = positions[ids[0]].first, maxX = minX, minY = positions[ids[0]].second, maxY = minY;
+    for (int v : ids) {
+        minX = std::min(minX, positions[v].first);
+        maxX = std::max(maxX, positions[v].first);
+        minY = std::min(minY, positions[v].second);
+        maxY = std::max(maxY, positions[v].second);
+    }
+    bool byX = maxX - minX >= maxY - minY;
+
+    int leftParts = numParts / 2;
+    auto middle = ids.begin() + (long) (ids.size() * leftParts / numParts);
+    std::nth_element(ids.begin(), middle, ids.end(), [&](int a, int b) {
+        return byX ? positions[a].first < positions[b].first : positions[a].second < positions[b].second;
+    });
+    std::vector<int> right(middle, ids.end());
+    ids.erase(middle, ids.end());
+    splitRegion(std::move(ids), leftParts, positions, parts);
+    splitRegion(std::move(right), numParts - leftParts, positions, parts);
+}
+
+void NetworkGenerator::assignRegions(const GeneratorOptions &options) {
+    int numStations = (int) stations.size();
+    int numDistricts = options.numDistricts > 0 ? options.numDistricts : std::max(1, numStations / 26);
+    numDistricts = std::min(numDistricts, numStations);
+
+    std::vector<int> ids(numStations);
+    for (int v = 0; v < numStations; v++) ids[v] = v;
+    std::vector<std::vector<int>> districts;
+    splitRegion(std::move(ids), numDistricts, positions, districts);
+
+    for (int d = 0; d < (int) districts.size(); d++) {
+        std::string district = "DISTRICT " + std::to_string(d + 1);
+        int numMunicipalities = std::min(std::max(1, options.municipalitiesPerDistrict), (int) districts[d].size());
+        std::vector<std::vector<int>> municipalities;
+        splitRegion(std::move(districts[d]), numMunicipalities, positions, municipalities);
+
+        for (int m = 0; m < (int) municipalities.size(); m++) {
+            std::string municipality = "MUNICIPALITY " + std::to_string(d + 1) + "-" + std::to_string(m + 1);
+            //as freguesias tem cerca de 4 estacoes
+            std::vector<std::vector<int>> townships;
+            int numTownships = ((int) municipalities[m].size() + 3) / 4;
+            splitRegion(std::move(municipalities[m]), numTownships, positions, townships);
+
+            for (int t = 0; t < (int) townships.size(); t++) {
+                std::string township = "Township " + std::to_string(d + 1) + "-" + std::to_string(m + 1) + "-" + std::to_string(t + 1);
+                for (int v : townships[t]) {
+                    stations[v].district = district;
+                    stations[v].municipality = municipality;
+                    stations[v].township = township;
+                }
+            }
+        }
+    }
+}
+
+const std::vector<NetworkGenerator::StationRow> &NetworkGenerator::getStations() const {
+    return stations;
+}
+
+const std::vector<NetworkGenerator::SegmentRow> &NetworkGenerator::getSegments() const {
+    return segments;
+}
+
+bool NetworkGenerator::write(const std::string &directory) const {
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+
+    std::ofstream stationFile(std::filesystem::path(directory) / STATIONS_FILE_NAME, std::ios::binary);
+    if (stationFile.fail()) return false;
+    stationFile << "Name,District,Municipality,Township,Line\n";
+    for (auto& station : stations) {
+        stationFile << station.name << ',' << station.district << ',' << station.municipality << ','
+                    << station.township << ',' << station.line << '\n';
+    }
+
+    std::ofstream networkFile(std::filesystem::path(directory) / NETWORK_FILE_NAME, std::ios::binary);
+    if (networkFile.fail()) return false;
+    networkFile << "Station_A,Station_B,Capacity,Service\n";
+    for (auto& segment : segments) {
+        networkFile << stations[segment.origin].name << ',' << stations[segment.dest].name << ',' << segment.capacity
+                    << ',' << (segment.service == SERVICE_ALFA_PENDULAR ? "ALFA PENDULAR" : "STANDARD") << '\n';
+    }
+
+    stationFile.flush();
+    networkFile.flush();
+    return !stationFile.fail() && !networkFile.fail();
+}
+
+void NetworkGenerator::fill(Graph &graph) const {
+    for (auto& station : stations) {
+        graph.addStation(station.name, station.district, station.municipality, station.township, station.line);
+    }
+    for (auto& segment : segments) {
+        graph.addBidirectionalLine(stations[segment.origin].name, stations[segment.dest].name, segment.capacity, segment.service);
+    }
+}
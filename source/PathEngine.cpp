@@ -0,0 +1,219 @@
+#include <vector>
+#include <algorithm>
+#include <limits>
+
+#include "../include/PathEngine.h"
+#include "../include/MutablePriorityQueue.h"
+#include "../include/RadixHeap.h"
+
+/**
+ * @brief The distance of the stations that can not be reached.
+ */
+static const double INFINITE_DISTANCE = std::numeric_limits<double>::infinity();
+
+PathEngine::PathEngine(const CSRGraph &graph): graph(&graph) {
+    int n = graph.getNumStations();
+    for (Search* search : {&forward, &backward}) {
+        search->nodes.resize(n);
+        search->distance.assign(n, 0);
+        search->line.assign(n, -1);
+        search->reached.assign(n, 0);
+        search->settled.assign(n, 0);
+        for (int i = 0; i < n; i++) {
+            search->nodes[i].id = i;
+        }
+    }
+    potential.assign(n, 0);
+    potentialStamp.assign(n, 0);
+    integerCosts = graph.hasIntegerCapacities();
+}
+
+void PathEngine::distancesFrom(int s, bool reverse, std::vector<double> &distance) const {
+    if (integerCosts) distancesWith<RadixHeap<QueueNode>>(s, reverse, distance);
+    else distancesWith<MutablePriorityQueue<QueueNode>>(s, reverse, distance);
+}
+
+template <class Queue>
+void PathEngine::distancesWith(int s, bool reverse, std::vector<double> &distance) const {
+    int n = graph->getNumStations();
+    std::vector<QueueNode> nodes(n);
+    std::vector<bool> visited(n, false);
+    distance.assign(n, INFINITE_DISTANCE);
+
+    Queue q;
+    distance[s] = 0;
+    nodes[s] = {s, 0, 0};
+    q.insert(&nodes[s]);
+
+    while (!q.empty()) {
+        int u = q.extractMin()->id;
+        visited[u] = true;
+        for (int e = graph->begin(u); e < graph->end(u); e++) {
+            //na pesquisa inversa usa-se a linha que chega a u
+            int line = reverse ? graph->getReverse(e) : e;
+            if (graph->getService(line) == SERVICE_NONE) continue;
+            int w = graph->getTarget(e);
+            double cost = distance[u] + graph->getCapacity(line);
+            if (visited[w] || cost >= distance[w]) continue;
+            bool inQueue = distance[w] != INFINITE_DISTANCE;
+            distance[w] = cost;
+            nodes[w].id = w;
+            nodes[w].key = cost;
+            if (inQueue) q.decreaseKey(&nodes[w]);
+            else q.insert(&nodes[w]);
+        }
+    }
+}
+
+void PathEngine::buildLandmarks(int k) {
+    fromLandmark.clear();
+    toLandmark.clear();
+    int n = graph->getNumStations();
+    if (n == 0 || k <= 0) return;
+
+    //cada landmark e a estacao mais longe das que ja foram escolhidas (as de outras componentes primeiro)
+    std::vector<double> score;
+    distancesFrom(0, false, score);
+    while ((int) fromLandmark.size() < k) {
+        int landmark = (int) (std::max_element(score.begin(), score.end()) - score.begin());
+        if (score[landmark] <= 0) break;
+
+        fromLandmark.emplace_back();
+        toLandmark.emplace_back();
+        distancesFrom(landmark, false, fromLandmark.back());
+        distancesFrom(landmark, true, toLandmark.back());
+
+        if (fromLandmark.size() == 1) score.assign(n, INFINITE_DISTANCE);
+        for (int v = 0; v < n; v++) {
+            score[v] = std::min(score[v], fromLandmark.back()[v]);
+        }
+        score[landmark] = 0;
+    }
+}
+
+int PathEngine::getNumLandmarks() const {
+    return (int) fromLandmark.size();
+}
+
+double PathEngine::getPotential(int v, int s, int t) {
+    if (usable.empty()) return 0;
+    if (potentialStamp[v] == stamp) return potential[v];
+
+    //limites inferiores das distancias de v ao destino e da origem a v (desigualdade triangular)
+    double toTarget = 0, fromSource = 0;
+    for (int l : usable) {
+        const std::vector<double>& from = fromLandmark[l];
+        const std::vector<double>& to = toLandmark[l];
+        toTarget = std::max({toTarget, to[v] - to[t], from[t] - from[v]});
+        fromSource = std::max({fromSource, to[s] - to[v], from[v] - from[s]});
+    }
+
+    potentialStamp[v] = stamp;
+    if (toTarget == INFINITE_DISTANCE || fromSource == INFINITE_DISTANCE) potential[v] = INFINITE_DISTANCE;
+    else potential[v] = (toTarget - fromSource) / 2;
+    return potential[v];
+}
+
+bool PathEngine::shortestPath(int s, int t, ServiceMask services, std::vector<int> &lines) {
+    lines.clear();
+    if (s == t) return true;
+
+    if (++stamp == 0) {
+        for (Search* search : {&forward, &backward}) {
+            std::fill(search->reached.begin(), search->reached.end(), 0);
+            std::fill(search->settled.begin(), search->settled.end(), 0);
+        }
+        std::fill(potentialStamp.begin(), potentialStamp.end(), 0);
+        stamp = 1;
+    }
+
+    usable.clear();
+    for (int l = 0; l < (int) fromLandmark.size(); l++) {
+        if (fromLandmark[l][s] != INFINITE_DISTANCE && toLandmark[l][s] != INFINITE_DISTANCE &&
+            fromLandmark[l][t] != INFINITE_DISTANCE && toLandmark[l][t] != INFINITE_DISTANCE) usable.push_back(l);
+    }
+
+    if (getPotential(s, s, t) == INFINITE_DISTANCE || getPotential(t, s, t) == INFINITE_DISTANCE) return false;
+
+    if (integerCosts && usable.empty()) return searchWith<RadixHeap<QueueNode>>(s, t, services, lines);
+    return searchWith<MutablePriorityQueue<QueueNode>>(s, t, services, lines);
+}
+
+template <class Queue>
+bool PathEngine::searchWith(int s, int t, ServiceMask services, std::vector<int> &lines) {
+    Queue queues[2];
+    Search* searches[2] = {&forward, &backward};
+    for (int side = 0; side < 2; side++) {
+        Search& search = *searches[side];
+        int v = side == 0 ? s : t;
+        search.distance[v] = 0;
+        search.line[v] = -1;
+        search.reached[v] = stamp;
+        search.nodes[v].key = side == 0 ? getPotential(v, s, t) : -getPotential(v, s, t);
+        queues[side].insert(&search.nodes[v]);
+    }
+
+    //o melhor caminho encontrado: a pesquisa direta chega a meetFrom, segue meetLine e a inversa continua em meetTo
+    double best = INFINITE_DISTANCE;
+    int meetFrom = -1, meetLine = -1, meetTo = -1;
+    double lastKey[2] = {-INFINITE_DISTANCE, -INFINITE_DISTANCE};
+
+    int side = 1;
+    while (!queues[0].empty() && !queues[1].empty()) {
+        side = 1 - side;
+        Search& search = *searches[side];
+        Search& other = *searches[1 - side];
+
+        QueueNode* node = queues[side].extractMin();
+        int u = node->id;
+        lastKey[side] = node->key;
+        //nenhum caminho ainda por encontrar e mais curto do que o melhor
+        if (lastKey[0] + lastKey[1] >= best) break;
+        search.settled[u] = stamp;
+
+        for (int e = graph->begin(u); e < graph->end(u); e++) {
+            //a pesquisa inversa percorre as linhas que chegam a u
+            int line = side == 0 ? e : graph->getReverse(e);
+            if (!(graph->getService(line) & services)) continue;
+            int w = graph->getTarget(e);
+            if (search.settled[w] == stamp) continue;
+
+            double cost = search.distance[u] + graph->getCapacity(line);
+            if (search.reached[w] != stamp) {
+                double p = getPotential(w, s, t);
+                if (p == INFINITE_DISTANCE) continue;
+                search.distance[w] = cost;
+                search.line[w] = line;
+                search.reached[w] = stamp;
+                search.nodes[w].key = side == 0 ? cost + p : cost - p;
+                queues[side].insert(&search.nodes[w]);
+            }
+            else if (cost < search.distance[w]) {
+                search.distance[w] = cost;
+                search.line[w] = line;
+                double p = getPotential(w, s, t);
+                search.nodes[w].key = side == 0 ? cost + p : cost - p;
+                queues[side].decreaseKey(&search.nodes[w]);
+            }
+
+            if (other.reached[w] == stamp && cost + other.distance[w] < best) {
+                best = cost + other.distance[w];
+                meetFrom = side == 0 ? u : w;
+                meetTo = side == 0 ? w : u;
+                meetLine = line;
+            }
+        }
+    }
+
+    if (meetLine == -1) return false;
+
+    for (int v = meetFrom; forward.line[v] != -1; v = graph->getTarget(graph->getReverse(forward.line[v]))) {
+        lines.push_back(forward.line[v]);
+    }
+    std::reverse(lines.begin(), lines.end());
+    lines.push_back(meetLine);
+    for (int v = meetTo; backward.line[v] != -1; v = graph->getTarget(backward.line[v])) {
+        lines.push_back(backward.line[v]);
+    }
+    return true;
+}
@@ -0,0 +1,229 @@
+#include <string>
+#include <vector>
+#include <chrono>
+#include <algorithm>
+#include <iostream>
+#include <csignal>
+
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "../include/QueryServer.h"
+#include "../include/SocketIO.h"
+
+/**
+ * @brief How long the server waits for a connection before checking if it was interrupted, in milliseconds.
+ */
+static const int POLL_INTERVAL = 250;
+
+/**
+ * @brief How long a worker waits for the rest of a frame, or for a client to read an answer, in milliseconds.
+ */
+static const int CLIENT_TIMEOUT = 5000;
+
+/**
+ * @brief The most requests of a connection answered before the worker gives it back.
+ */
+static const int REQUESTS_PER_TURN = 64;
+
+/**
+ * @brief Set by the signal handler when the server must stop.
+ */
+static volatile std::sig_atomic_t interrupted = 0;
+
+static void onSignal(int) {
+    interrupted = 1;
+}
+
+QueryServer::QueryServer(MaxFlowAlgorithm algorithm, unsigned numWorkers, const std::string& datasetDirectory) {
+    if (numWorkers == 0) numWorkers = 1;
+    graph.setMaxFlowAlgorithm(algorithm);
+    graph.setDatasetDirectory(datasetDirectory);
+    graph.fill();
+    //as consultas dos trabalhadores so leem o grafo, por isso o snapshot e as folhas sao preparados antes
+    graph.getLeaves();
+    for (unsigned i = 0; i < numWorkers; i++) {
+        runners.emplace_back(new BatchRunner(graph, FORMAT_JSON_LINES, false));
+    }
+    //nenhuma das pontas bloqueia: se o pipe estiver cheio o run ja vai acordar
+    if (pipe(wakePipe) == 0) {
+        fcntl(wakePipe[0], F_SETFL, O_NONBLOCK);
+        fcntl(wakePipe[1], F_SETFL, O_NONBLOCK);
+    }
+    active.assign(numWorkers, -1);
+    for (unsigned i = 0; i < numWorkers; i++) {
+        workers.emplace_back(&QueryServer::workerLoop, this, (int) i);
+    }
+}
+
+QueryServer::~QueryServer() {
+    stop();
+    closeSocket(wakePipe[0]);
+    closeSocket(wakePipe[1]);
+}
+
+bool QueryServer::isLoaded() const {
+    return !graph.getStationSet().empty();
+}
+
+bool QueryServer::listen(const std::string &address) {
+    closeSocket(listener);
+    listener = listenOn(address);
+    this->address = address;
+    return listener >= 0;
+}
+
+void QueryServer::run() {
+    interrupted = 0;
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    //um cliente que fecha a ligacao nao pode terminar o servidor
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::vector<pollfd> fds;
+    while (!interrupted) {
+        fds.assign({{listener, POLLIN, 0}, {wakePipe[0], POLLIN, 0}});
+        for (const Connection& client : idle) fds.push_back({client.socket, POLLIN, 0});
+        if (poll(fds.data(), fds.size(), POLL_INTERVAL) <= 0) continue;
+
+        bool ready = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            //as ligacoes com pedidos (ou fechadas) vao para os trabalhadores, as outras continuam a espera
+            std::size_t kept = 0;
+            for (std::size_t i = 0; i < idle.size(); i++) {
+                if (fds[i + 2].revents != 0) {
+                    pending.push_back(idle[i]);
+                    ready = true;
+                }
+                else idle[kept++] = idle[i];
+            }
+            idle.resize(kept);
+
+            if (fds[1].revents != 0) {
+                char buffer[64];
+                while (read(wakePipe[0], buffer, sizeof(buffer)) > 0);
+                idle.insert(idle.end(), returned.begin(), returned.end());
+                returned.clear();
+            }
+        }
+
+        if (fds[0].revents & POLLIN) {
+            int client = accept(listener, nullptr, nullptr);
+            if (client >= 0) {
+                setTimeout(client, CLIENT_TIMEOUT);
+                idle.push_back({client, 0});
+            }
+        }
+        if (ready) wake.notify_all();
+    }
+
+    stop();
+}
+
+void QueryServer::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!stopping) {
+            stopping = true;
+            for (const Connection& client : pending) closeSocket(client.socket);
+            for (const Connection& client : idle) closeSocket(client.socket);
+            for (const Connection& client : returned) closeSocket(client.socket);
+            pending.clear();
+            idle.clear();
+            returned.clear();
+            //acorda os trabalhadores que estao a espera de pedidos
+            for (int client : active) {
+                if (client >= 0) shutdown(client, SHUT_RDWR);
+            }
+        }
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        if (worker.joinable()) worker.join();
+    }
+
+    if (listener >= 0) {
+        closeSocket(listener);
+        listener = -1;
+        if (address.compare(0, 5, "unix:") == 0) removeSocketFile(address.substr(5));
+    }
+}
+
+void QueryServer::workerLoop(int worker) {
+    while (true) {
+        Connection client;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || !pending.empty(); });
+            if (stopping) return;
+            client = pending.front();
+            pending.pop_front();
+            active[worker] = client.socket;
+        }
+
+        bool open = serve(client, *runners[worker]);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            active[worker] = -1;
+            if (open && !stopping) {
+                returned.push_back(client);
+                char signal = 0;
+                ssize_t written = write(wakePipe[1], &signal, 1);
+                (void) written;
+                continue;
+            }
+        }
+        closeSocket(client.socket);
+    }
+}
+
+bool QueryServer::serve(Connection &client, BatchRunner &runner) {
+    std::string request;
+    for (int i = 0; i < REQUESTS_PER_TURN; i++) {
+        if (!readFrame(client.socket, request)) return false;
+        if (!writeFrame(client.socket, runner.answer(request, ++client.requests))) return false;
+
+        //sem outro pedido a espera a ligacao volta para o run
+        pollfd fd{client.socket, POLLIN, 0};
+        if (poll(&fd, 1, 0) <= 0) break;
+    }
+    return true;
+}
+
+bool runQueryClient(const std::string &address, std::istream &in, std::ostream &out) {
+    int server = connectTo(address);
+    if (server < 0) return false;
+
+    std::string request, answer;
+    std::vector<double> latencies;
+    bool ok = true;
+    while (std::getline(in, request)) {
+        if (!request.empty() && request.back() == '\r') request.pop_back();
+        if (request.empty()) continue;
+
+        auto start = std::chrono::steady_clock::now();
+        if (!writeFrame(server, request) || !readFrame(server, answer)) {
+            ok = false;
+            break;
+        }
+        std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        latencies.push_back(elapsed.count());
+        out << answer << '\n';
+    }
+    out.flush();
+    closeSocket(server);
+
+    if (!latencies.empty()) {
+        double total = 0;
+        for (double latency : latencies) total += latency;
+        std::sort(latencies.begin(), latencies.end());
+        std::cerr << latencies.size() << " requests, latency (us): mean " << total / (double) latencies.size()
+                  << ", median " << latencies[latencies.size() / 2]
+                  << ", p99 " << latencies[latencies.size() * 99 / 100] << std::endl;
+    }
+    return ok;
+}
@@ -0,0 +1,191 @@
+#include <string>
+#include <cstring>
+#include <cerrno>
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+
+#include "../include/SocketIO.h"
+
+#ifdef MSG_NOSIGNAL
+static const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+static const int SEND_FLAGS = 0;
+#endif
+
+/**
+ * @brief The number of connections waiting to be accepted.
+ */
+static const int BACKLOG = 64;
+
+/**
+ * @brief Parses an address ("unix:<path>" or "tcp:<port>").
+ *
+ * @param address The address.
+ * @param unixAddress The address of a Unix domain socket. Initialized if the address is "unix:".
+ * @param tcpAddress The loopback address of a TCP socket. Initialized if the address is "tcp:".
+ * @param isUnix True if the address is "unix:".
+ * @return True if the address is valid.
+ */
+static bool parseAddress(const std::string& address, sockaddr_un& unixAddress, sockaddr_in& tcpAddress, bool& isUnix) {
+    if (address.compare(0, 5, "unix:") == 0) {
+        std::string path = address.substr(5);
+        if (path.empty() || path.size() >= sizeof(unixAddress.sun_path)) return false;
+        std::memset(&unixAddress, 0, sizeof(unixAddress));
+        unixAddress.sun_family = AF_UNIX;
+        std::memcpy(unixAddress.sun_path, path.c_str(), path.size() + 1);
+        isUnix = true;
+        return true;
+    }
+    if (address.compare(0, 4, "tcp:") == 0) {
+        std::string port = address.substr(4);
+        if (port.empty() || port.size() > 5 || port.find_first_not_of("0123456789") != std::string::npos) return false;
+        int number = std::stoi(port);
+        if (number <= 0 || number > 65535) return false;
+        std::memset(&tcpAddress, 0, sizeof(tcpAddress));
+        tcpAddress.sin_family = AF_INET;
+        tcpAddress.sin_port = htons((std::uint16_t) number);
+        tcpAddress.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        isUnix = false;
+        return true;
+    }
+    return false;
+}
+
+int listenOn(const std::string &address) {
+    sockaddr_un unixAddress{};
+    sockaddr_in tcpAddress{};
+    bool isUnix;
+    if (!parseAddress(address, unixAddress, tcpAddress, isUnix)) return -1;
+
+    int s = socket(isUnix ? AF_UNIX : AF_INET, SOCK_STREAM, 0);
+    if (s < 0) return -1;
+
+    int result;
+    if (isUnix) {
+        if (!removeSocketFile(unixAddress.sun_path)) {
+            close(s);
+            return -1;
+        }
+        result = bind(s, (sockaddr*) &unixAddress, sizeof(unixAddress));
+    }
+    else {
+        //as ligacoes aceites herdam o TCP_NODELAY
+        int reuse = 1, noDelay = 1;
+        setsockopt(s, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        result = bind(s, (sockaddr*) &tcpAddress, sizeof(tcpAddress));
+    }
+    if (result < 0 || listen(s, BACKLOG) < 0) {
+        close(s);
+        return -1;
+    }
+    return s;
+}
+
+bool removeSocketFile(const std::string &path) {
+    struct stat info{};
+    if (lstat(path.c_str(), &info) < 0) return errno == ENOENT;
+    //so um socket (de um servidor anterior) pode ser apagado, nunca um ficheiro ou uma ligacao simbolica
+    if (!S_ISSOCK(info.st_mode)) return false;
+    return unlink(path.c_str()) == 0 || errno == ENOENT;
+}
+
+int connectTo(const std::string &address) {
+    sockaddr_un unixAddress{};
+    sockaddr_in tcpAddress{};
+    bool isUnix;
+    if (!parseAddress(address, unixAddress, tcpAddress, isUnix)) return -1;
+
+    int s = socket(isUnix ? AF_UNIX : AF_INET, SOCK_STREAM, 0);
+    if (s < 0) return -1;
+
+    int result;
+    if (isUnix) {
+        result = connect(s, (sockaddr*) &unixAddress, sizeof(unixAddress));
+    }
+    else {
+        //cada pergunta e uma mensagem pequena, que nao deve esperar por mais dados
+        int noDelay = 1;
+        setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+        result = connect(s, (sockaddr*) &tcpAddress, sizeof(tcpAddress));
+    }
+    if (result < 0) {
+        close(s);
+        return -1;
+    }
+    return s;
+}
+
+bool setTimeout(int socket, int milliseconds) {
+    timeval timeout{};
+    timeout.tv_sec = milliseconds / 1000;
+    timeout.tv_usec = (milliseconds % 1000) * 1000;
+    return setsockopt(socket, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) == 0 &&
+           setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout)) == 0;
+}
+
+/**
+ * @brief Reads exactly size bytes, retrying after interruptions.
+ *
+ * @return True if every byte was read.
+ */
+static bool readFully(int socket, char* data, std::size_t size) {
+    while (size > 0) {
+        ssize_t n = recv(socket, data, size, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        size -= (std::size_t) n;
+    }
+    return true;
+}
+
+/**
+ * @brief Writes exactly size bytes, retrying after interruptions.
+ *
+ * @return True if every byte was written.
+ */
+static bool writeFully(int socket, const char* data, std::size_t size) {
+    while (size > 0) {
+        ssize_t n = send(socket, data, size, SEND_FLAGS);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        data += n;
+        size -= (std::size_t) n;
+    }
+    return true;
+}
+
+bool readFrame(int socket, std::string &payload) {
+    unsigned char header[4];
+    if (!readFully(socket, (char*) header, sizeof(header))) return false;
+    std::uint32_t size = (std::uint32_t) header[0] << 24 | (std::uint32_t) header[1] << 16 |
+                         (std::uint32_t) header[2] << 8 | (std::uint32_t) header[3];
+    if (size > MAX_FRAME_SIZE) return false;
+    payload.resize(size);
+    return size == 0 || readFully(socket, &payload[0], size);
+}
+
+bool writeFrame(int socket, const std::string &payload) {
+    if (payload.size() > MAX_FRAME_SIZE) return false;
+    std::uint32_t size = (std::uint32_t) payload.size();
+    std::string frame;
+    frame.reserve(4 + payload.size());
+    frame += (char) (size >> 24);
+    frame += (char) (size >> 16);
+    frame += (char) (size >> 8);
+    frame += (char) size;
+    frame += payload;
+    return writeFully(socket, frame.data(), frame.size());
+}
+
+void closeSocket(int socket) {
+    if (socket >= 0) close(socket);
+}
@@ -6,151 +6,161 @@
 
 #include "../include/StationEdge.h"
 
+/************************* Service  **************************/
+
+/**
+ * @brief The name of each service of the railway network.
+ */
+static const std::pair<std::string_view, ServiceMask> SERVICE_NAMES[] = {
+    {"STANDARD", SERVICE_STANDARD},
+    {"ALFA PENDULAR", SERVICE_ALFA_PENDULAR}
+};
+
+ServiceMask parseService(std::string_view service) {
+    std::string_view::size_type end = service.find_last_not_of(" \t\r\n");
+    if (end == std::string_view::npos) return SERVICE_OTHER;
+    for (auto& p : SERVICE_NAMES) {
+        if (service.compare(0, end + 1, p.first) == 0) return p.second;
+    }
+    return SERVICE_OTHER;
+}
+
 /************************* Station  **************************/
 
-Station::Station(const std::string &name, const std::string &district, const std::string &municipality, const std::string &township, const std::string &line):
-    name(name), district(district), municipality(municipality), township(township), line(line) {
-    this->setVisited(false);
-    this->setPath(nullptr);
-    this->setCost(0);
+Station::Station(const std::string &name, const std::string &district, const std::string &municipality, const std::string &township, const std::string &line, SlabPool<Edge> &edgePool):
+    name(name), edgePool(&edgePool) {
+    SymbolTable& symbols = SymbolTable::global();
+    this->district = symbols.intern(district);
+    this->municipality = symbols.intern(municipality);
+    this->township = symbols.intern(township);
+    this->line = symbols.intern(line);
+    this->setId(-1);
 }
 
-std::string Station::getDistrict() const {
-    return this->district;
+const std::string& Station::getDistrict() const {
+    return SymbolTable::global().getString(this->district);
 }
 
-std::string Station::getLine() const {
-    return this->line;
+const std::string& Station::getLine() const {
+    return SymbolTable::global().getString(this->line);
 }
 
-std::string Station::getMunicipality() const {
-    return this->municipality;
+const std::string& Station::getMunicipality() const {
+    return SymbolTable::global().getString(this->municipality);
 }
 
-std::string Station::getName() const {
+const std::string& Station::getName() const {
     return this->name;
 }
 
-std::string Station::getTownShip() const {
-    return this->township;
+const std::string& Station::getTownShip() const {
+    return SymbolTable::global().getString(this->township);
 }
 
-std::vector<Edge *> Station::getAdj() const {
-    return this->adj;
-}
-
-std::vector<Edge *> Station::getIncoming() const {
-    return this->incoming;
+Symbol Station::getDistrictId() const {
+    return this->district;
 }
 
-bool Station::isVisited() const {
-    return this->visited;
+Symbol Station::getMunicipalityId() const {
+    return this->municipality;
 }
 
-void Station::setVisited(bool vis) {
-    this->visited = vis;
+Symbol Station::getTownShipId() const {
+    return this->township;
 }
 
-Edge *Station::getPath() const {
-    return this->path;
+Symbol Station::getLineId() const {
+    return this->line;
 }
 
-void Station::setPath(Edge *path) {
-    this->path = path;
+const std::vector<Edge *>& Station::getAdj() const {
+    return this->adj;
 }
 
-void Station::setCost(double cost) {
-    this->cost = cost;
+const std::vector<Edge *>& Station::getIncoming() const {
+    return this->incoming;
 }
 
-double Station::getCost() const {
-    return this->cost;
+void Station::setId(int id) {
+    this->id = id;
 }
 
-bool Station::operator<(Station &station) const {
-    return this->cost < station.getCost();
+int Station::getId() const {
+    return this->id;
 }
 
-Edge* Station::addLine(Station *dest, const double capacity, const std::string &service) {
-    Edge* edge = new Edge(this, dest, capacity, service);
+Edge* Station::addLine(Station *dest, const double capacity, ServiceMask service) {
+    Edge* edge = edgePool->create(this, dest, capacity, service);
+    edge->adjIndex = (int) adj.size();
     adj.push_back(edge);
+    edge->incomingIndex = (int) dest->incoming.size();
     dest->incoming.push_back(edge);
     return edge;
 }
 
-bool Station::removeEdge(std::string name) {
+void Station::unlinkEdge(Edge *edge) {
+    //troca a aresta com a ultima de cada lista, atualizando a posicao da que mudou de sitio
+    Edge* last = adj.back();
+    adj[edge->adjIndex] = last;
+    last->adjIndex = edge->adjIndex;
+    adj.pop_back();
+
+    std::vector<Edge*>& destIncoming = edge->getDest()->incoming;
+    last = destIncoming.back();
+    destIncoming[edge->incomingIndex] = last;
+    last->incomingIndex = edge->incomingIndex;
+    destIncoming.pop_back();
+
+    edge->adjIndex = -1;
+    edge->incomingIndex = -1;
+}
+
+bool Station::removeEdge(const std::string& name) {
     bool removeEdge = false;
-    auto it = adj.begin();
-    while (it != adj.end()) {
-        Edge* edge = *it;
-        Station* s = edge->getDest();
-        if (s->getName() == name) {
-            it = adj.erase(it);
+    //percorre de tras para a frente, porque a ultima aresta passa para a posicao da removida
+    for (int i = (int) adj.size() - 1; i >= 0; i--) {
+        Edge* edge = adj[i];
+        if (edge->getDest()->getName() == name) {
             deleteEdge(edge);
             removeEdge = true;
         }
-        else {
-            it++;
-        }
     }
 
     return removeEdge;
 }
 
 void Station::deleteEdge(Edge *edge) {
-    Station *dest = edge->getDest();
-    auto it = dest->incoming.begin();
-    while (it != dest->incoming.end()) {
-        if ((*it)->getOrigin()->getName() == name) {
-            it = dest->incoming.erase(it);
-        }
-        else {
-            it++;
-        }
-    }
-    delete edge;
+    if (edge->adjIndex != -1) unlinkEdge(edge);
+    //a linha inversa deixa de apontar para esta
+    if (edge->getReverse() != nullptr) edge->getReverse()->setReverse(nullptr);
+    edgePool->destroy(edge);
 }
 
 void Station::removeOutgoingEdges() {
-    auto it = adj.begin();
-    while (it != adj.end()) {
-        Edge *edge = *it;
-        it = adj.erase(it);
-        deleteEdge(edge);
+    while (!adj.empty()) {
+        deleteEdge(adj.back());
     }
 }
 
 Edge *Station::removeAndStoreEdge(Station *dest) {
     if (dest == nullptr) return nullptr;
-    bool exists = false;
-    Edge* edge;
-    auto it = this->adj.begin();
-    while (it != this->adj.end()) {
-        if ((*it)->getDest()->getName() == dest->getName()) {
-            edge = *it;
-            this->adj.erase(it);
-            exists = true;
-            break;
-        }
-        it++;
+    for (auto edge : adj) {
+        if (edge->getDest() != dest) continue;
+        unlinkEdge(edge);
+        if (edge->getReverse() != nullptr) edge->getReverse()->setReverse(nullptr);
+        edge->setReverse(nullptr);
+        return edge;
     }
-    if (!exists) return nullptr;
-    it = this->incoming.begin();
-    while (it != this->incoming.end()) {
-        if ((*it)->getOrigin()->getName() == dest->getName()) {
-            this->incoming.erase(it);
-            break;
-        }
-        it++;
-    }
-    return edge;
+    return nullptr;
 }
 
 /************************* Edge  **************************/
 
-Edge::Edge(Station *origin, Station *dest, const double capacity, const std::string &service): origin(origin), dest(dest), capacity(capacity), service(service) {
+Edge::Edge(Station *origin, Station *dest, const double capacity, ServiceMask service): origin(origin), dest(dest), capacity(capacity), service(service) {
     this->reverse = nullptr;
-    this->flow = 0;
+    this->adjIndex = -1;
+    this->incomingIndex = -1;
+    this->id = -1;
 }
 
 Station *Edge::getDest() const {
@@ -165,7 +175,7 @@ double Edge::getCapacity() const {
     return this->capacity;
 }
 
-std::string Edge::getService() const {
+ServiceMask Edge::getService() const {
     return this->service;
 }
 
@@ -177,11 +187,10 @@ Edge *Edge::getReverse() const {
     return this->reverse;
 }
 
-void Edge::setFlow(double flow) {
-    this->flow = flow;
+void Edge::setId(int id) {
+    this->id = id;
 }
 
-double Edge::getFlow() const {
-    return this->flow;
+int Edge::getId() const {
+    return this->id;
 }
-
@@ -0,0 +1,28 @@
+#include "../include/SymbolTable.h"
+
+SymbolTable &SymbolTable::global() {
+    static SymbolTable table;
+    return table;
+}
+
+Symbol SymbolTable::intern(std::string_view s) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = index.find(s);
+    if (it != index.end()) return it->second;
+
+    //a chave aponta para a copia guardada na tabela, que nunca muda de sitio
+    Symbol symbol = (Symbol) strings.size();
+    strings.emplace_back(s);
+    index.insert({strings.back(), symbol});
+    return symbol;
+}
+
+const std::string &SymbolTable::getString(Symbol symbol) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return strings[symbol];
+}
+
+int SymbolTable::size() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return (int) strings.size();
+}
@@ -0,0 +1,81 @@
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+#include "../include/ThreadPool.h"
+
+ThreadPool::ThreadPool(unsigned size) {
+    if (size == 0) size = 1;
+    for (unsigned i = 1; i < size; i++) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, (int) i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+int ThreadPool::size() const {
+    return (int) workers.size() + 1;
+}
+
+void ThreadPool::parallelFor(int n, const std::function<void(int, int)>& loopBody) {
+    if (n <= 0) return;
+    std::lock_guard<std::mutex> loopLock(loopMutex);
+
+    if (workers.empty() || n == 1) {
+        for (int i = 0; i < n; i++) loopBody(i, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        body = loopBody;
+        iterations = n;
+        next = 0;
+        running = (int) workers.size();
+        generation++;
+    }
+    wake.notify_all();
+
+    work(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this] { return running == 0; });
+    body = nullptr;
+}
+
+void ThreadPool::workerLoop(int worker) {
+    unsigned seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this, seen] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+
+        work(worker);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running--;
+        }
+        done.notify_one();
+    }
+}
+
+void ThreadPool::work(int worker) {
+    for (int i = next++; i < iterations; i = next++) {
+        body(i, worker);
+    }
+}
@@ -5,8 +5,12 @@
 #include "../include/UserInterface.h"
 #include "../include/Graph.h"
 
+UserInterface::UserInterface(MaxFlowAlgorithm algorithm, const std::string& datasetDirectory): algorithm(algorithm), datasetDirectory(datasetDirectory) {}
+
 void UserInterface::showMenu() {
     Graph graph{};
+    graph.setMaxFlowAlgorithm(algorithm);
+    graph.setDatasetDirectory(datasetDirectory);
     bool done = false;
     char userchoice;
 
@@ -0,0 +1,97 @@
+#include <iostream>
+#include <string>
+#include <cstdlib>
+
+#include "../include/NetworkGenerator.h"
+
+/**
+ * @brief Parses an integer argument.
+ *
+ * @param text The argument.
+ * @param value The value. Initialized only if the argument is a valid integer.
+ * @return True if the argument is a valid integer.
+ */
+static bool parseInt(const char* text, long& value) {
+    char* end;
+    long parsed = std::strtol(text, &end, 10);
+    if (*text == '\0' || *end != '\0') return false;
+    value = parsed;
+    return true;
+}
+
+/**
+ * @brief Parses a real argument.
+ *
+ * @param text The argument.
+ * @param value The value. Initialized only if the argument is a valid number.
+ * @return True if the argument is a valid number.
+ */
+static bool parseReal(const char* text, double& value) {
+    char* end;
+    double parsed = std::strtod(text, &end);
+    if (*text == '\0' || *end != '\0') return false;
+    value = parsed;
+    return true;
+}
+
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " --out directory [--stations n] [--districts n] [--municipalities n]"
+              << " [--line-length x] [--topology tree|mesh|ring] [--mesh-ratio x] [--alfa-ratio x]"
+              << " [--min-capacity n] [--max-capacity n] [--capacity-step n] [--capacities uniform|geometric]"
+              << " [--seed n]" << std::endl;
+}
+
+/**
+ * @brief Writes a synthetic network into a directory, in the schema of the dataset, so it can be loaded with
+ * "project --dataset directory". The same options and seed always give the same files.
+ */
+int main(int argc, char* argv[]) {
+    GeneratorOptions options;
+    std::string directory;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        const char* value = argv[++i];
+        long number;
+        double real;
+        bool ok = true;
+
+        if (arg == "--out") directory = value;
+        else if (arg == "--stations" && (ok = parseInt(value, number) && number >= 2)) options.numStations = (int) number;
+        else if (arg == "--districts" && (ok = parseInt(value, number) && number >= 1)) options.numDistricts = (int) number;
+        else if (arg == "--municipalities" && (ok = parseInt(value, number) && number >= 1)) options.municipalitiesPerDistrict = (int) number;
+        else if (arg == "--line-length" && (ok = parseReal(value, real) && real >= 2)) options.meanLineLength = real;
+        else if (arg == "--topology") ok = parseTopology(value, options.topology);
+        else if (arg == "--mesh-ratio" && (ok = parseReal(value, real) && real >= 0)) options.meshRatio = real;
+        else if (arg == "--alfa-ratio" && (ok = parseReal(value, real) && real >= 0 && real <= 1)) options.alfaPendularRatio = real;
+        else if (arg == "--min-capacity" && (ok = parseInt(value, number) && number >= 1)) options.minCapacity = (int) number;
+        else if (arg == "--max-capacity" && (ok = parseInt(value, number) && number >= 1)) options.maxCapacity = (int) number;
+        else if (arg == "--capacity-step" && (ok = parseInt(value, number) && number >= 1)) options.capacityStep = (int) number;
+        else if (arg == "--capacities") ok = parseCapacityDistribution(value, options.capacityDistribution);
+        else if (arg == "--seed" && (ok = parseInt(value, number) && number >= 0)) options.seed = (unsigned) number;
+        else ok = false;
+
+        if (!ok) {
+            std::cerr << "Invalid option " << arg << " " << value << std::endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (directory.empty() || options.maxCapacity < options.minCapacity) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    NetworkGenerator generator(options);
+    if (!generator.write(directory)) {
+        std::cerr << "Could not write the network into " << directory << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << generator.getStations().size() << " stations and " << generator.getSegments().size()
+              << " lines into " << directory << std::endl;
+    return 0;
+}
@@ -1,7 +1,163 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <cstdlib>
+
 #include "../include/UserInterface.h"
+#include "../include/Graph.h"
+#include "../include/BatchRunner.h"
+#include "../include/QueryServer.h"
+#include "../include/constants.h"
+
+/**
+ * @brief Converts the csv files of the dataset into the binary dataset and builds the route index.
+ *
+ * @param datasetDirectory The directory of the dataset.
+ * @return The exit code of the program.
+ */
+static int convertDataset(const std::string& datasetDirectory) {
+    Graph graph;
+    graph.setDatasetDirectory(datasetDirectory);
+    graph.readStations();
+    graph.readNetwork();
+    if (graph.getStationSet().empty()) {
+        std::cerr << "Could not read " << graph.getDatasetPath(STATIONS_FILE_NAME) << std::endl;
+        return 1;
+    }
+    std::string binaryPath = graph.getDatasetPath(BINARY_DATASET_NAME);
+    if (!graph.saveBinaryDataset()) {
+        std::cerr << "Could not write " << binaryPath << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << binaryPath << " (" << graph.getStationSet().size() << " stations)" << std::endl;
+    graph.buildRouteIndex();
+    std::cout << "Route index in " << graph.getDatasetPath(STANDARD_ROUTE_INDEX_NAME) << " and "
+              << graph.getDatasetPath(ALFA_PENDULAR_ROUTE_INDEX_NAME) << std::endl;
+    return 0;
+}
+
+/**
+ * @brief Loads the graph once and answers the queries of a file (or of the standard input) without the menu.
+ *
+ * @param input The path of the queries, "-" for the standard input.
+ * @param format The format of the results, written to the standard output.
+ * @param parallel If true, consecutive maxflow and grid-to-station queries are computed in parallel.
+ * @param algorithm The max flow algorithm.
+ * @param datasetDirectory The directory of the dataset.
+ * @return The exit code of the program.
+ */
+static int runBatch(const std::string& input, BatchFormat format, bool parallel, MaxFlowAlgorithm algorithm, const std::string& datasetDirectory) {
+    std::ios::sync_with_stdio(false);
+    std::ifstream file;
+    if (input != "-") {
+        file.open(input, std::ios::binary);
+        if (file.fail()) {
+            std::cerr << "Could not read " << input << std::endl;
+            return 1;
+        }
+    }
+
+    Graph graph;
+    graph.setMaxFlowAlgorithm(algorithm);
+    graph.setDatasetDirectory(datasetDirectory);
+    graph.fill();
+    if (graph.getStationSet().empty()) {
+        std::cerr << "Could not read " << graph.getDatasetPath(STATIONS_FILE_NAME) << std::endl;
+        return 1;
+    }
+
+    BatchRunner runner(graph, format, parallel);
+    bool ok = input == "-" ? runner.run(std::cin, "stdin", std::cout) : runner.run(file, input, std::cout);
+    if (!ok) {
+        std::cerr << "Could not read " << input << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+/**
+ * @brief Loads the network and answers the queries sent to a local socket until SIGINT or SIGTERM.
+ *
+ * @param address The address of the socket, "unix:<path>" or "tcp:<port>".
+ * @param numWorkers The number of clients served at the same time.
+ * @param algorithm The max flow algorithm.
+ * @param datasetDirectory The directory of the dataset.
+ * @return The exit code of the program.
+ */
+static int runServer(const std::string& address, unsigned numWorkers, MaxFlowAlgorithm algorithm, const std::string& datasetDirectory) {
+    QueryServer server(algorithm, numWorkers, datasetDirectory);
+    if (!server.isLoaded()) {
+        std::cerr << "Could not read the dataset in " << datasetDirectory << std::endl;
+        return 1;
+    }
+    if (!server.listen(address)) {
+        std::cerr << "Could not listen on " << address << std::endl;
+        return 1;
+    }
+    std::cerr << "Listening on " << address << std::endl;
+    server.run();
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    MaxFlowAlgorithm algorithm = EDMONDS_KARP;
+    BatchFormat format = FORMAT_JSON_LINES;
+    std::string batch, serve, datasetDirectory = DATASET_DIRECTORY;
+    bool convert = false;
+    bool parallel = false;
+    unsigned numWorkers = std::thread::hardware_concurrency();
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--engine" && i + 1 < argc && parseMaxFlowAlgorithm(argv[i + 1], algorithm)) {
+            i++;
+            continue;
+        }
+        if (arg == "--dataset" && i + 1 < argc) {
+            datasetDirectory = argv[++i];
+            continue;
+        }
+        if (arg == "--batch" && i + 1 < argc) {
+            batch = argv[++i];
+            continue;
+        }
+        if (arg == "--format" && i + 1 < argc && parseBatchFormat(argv[i + 1], format)) {
+            i++;
+            continue;
+        }
+        if (arg == "--parallel") {
+            parallel = true;
+            continue;
+        }
+        if (arg == "--serve" && i + 1 < argc) {
+            serve = argv[++i];
+            continue;
+        }
+        if (arg == "--workers" && i + 1 < argc && std::atoi(argv[i + 1]) > 0) {
+            numWorkers = (unsigned) std::atoi(argv[++i]);
+            continue;
+        }
+        if (arg == "--client" && i + 1 < argc) {
+            if (runQueryClient(argv[i + 1], std::cin, std::cout)) return 0;
+            std::cerr << "Could not query " << argv[i + 1] << std::endl;
+            return 1;
+        }
+        if (arg == "--convert") {
+            convert = true;
+            continue;
+        }
+        std::cerr << "Usage: " << argv[0] << " [--dataset directory] [--engine edmonds-karp|dinic|push-relabel] [--convert]"
+                  << " [--batch file|- [--format jsonl|csv] [--parallel]]"
+                  << " [--serve unix:path|tcp:port [--workers n]] [--client unix:path|tcp:port]" << std::endl;
+        return 1;
+    }
+
+    if (convert) return convertDataset(datasetDirectory);
+    if (!batch.empty()) return runBatch(batch, format, parallel, algorithm, datasetDirectory);
+    if (!serve.empty()) return runServer(serve, numWorkers, algorithm, datasetDirectory);
 
-int main() {
-    UserInterface ui{};
+    UserInterface ui{algorithm, datasetDirectory};
     ui.showMenu();
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,467 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <functional>
+#include <memory>
+#include <random>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <system_error>
+
+#include <unistd.h>
+#include <sys/socket.h>
+
+#include "../include/Graph.h"
+#include "../include/NetworkGenerator.h"
+#include "../include/BinaryDataset.h"
+#include "../include/CSVReader.h"
+#include "../include/SocketIO.h"
+
+/**
+ * @brief The number of checks that failed.
+ */
+static int failures = 0;
+
+/**
+ * @brief Counts and reports a failed check, with what was being checked.
+ */
+#define CHECK(condition, context) \
+    do { \
+        if (!(condition)) { \
+            failures++; \
+            std::cerr << __FILE__ << ":" << __LINE__ << ": " << #condition << " failed (" << context << ")" << std::endl; \
+        } \
+    } while (0)
+
+/**
+ * @brief As CHECK, but leaves the test, for the checks the rest of the test depends on.
+ */
+#define REQUIRE(condition, context) \
+    do { \
+        int before = failures; \
+        CHECK(condition, context); \
+        if (failures != before) return; \
+    } while (0)
+
+/**
+ * @brief The number of pairs of stations checked in each network.
+ */
+static const int NUM_PAIRS = 100;
+
+/**
+ * @brief The networks checked by the tests: the dataset and a small synthetic network of each topology.
+ */
+static const char* const NETWORKS[] = {"dataset", "tree", "mesh", "ring"};
+
+/**
+ * @brief Checks if two flows are the same, up to the rounding of the sums.
+ */
+static bool sameFlow(double a, double b) {
+    return std::fabs(a - b) <= 1e-9 * std::max(1.0, std::fabs(a));
+}
+
+/**
+ * @brief A directory in the temporary directory of the system, removed with everything in it when destroyed.
+ */
+class TemporaryDirectory {
+    std::filesystem::path path;
+
+public:
+    TemporaryDirectory() {
+        static int count = 0;
+        path = std::filesystem::temp_directory_path() /
+               ("da-tests-" + std::to_string(getpid()) + "-" + std::to_string(count++));
+        std::filesystem::create_directories(path);
+    }
+
+    ~TemporaryDirectory() {
+        std::error_code error;
+        std::filesystem::remove_all(path, error);
+    }
+
+    TemporaryDirectory(const TemporaryDirectory&) = delete;
+    TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+
+    const std::filesystem::path& getPath() const { return path; }
+};
+
+/**
+ * @brief Copies the csv files of the dataset into a directory, so the tests never write into the dataset.
+ *
+ * @param directory The directory.
+ */
+static void copyDataset(const std::filesystem::path& directory) {
+    for (const std::string& name : {STATIONS_FILE_NAME, NETWORK_FILE_NAME}) {
+        std::filesystem::copy_file(std::filesystem::path(TEST_DATASET_DIRECTORY) / name, directory / name);
+    }
+}
+
+/**
+ * @brief Gets the parameters of a small synthetic network.
+ *
+ * @param topology The shape of the network.
+ */
+static GeneratorOptions smallNetwork(Topology topology) {
+    GeneratorOptions options;
+    options.numStations = 300;
+    options.topology = topology;
+    options.seed = 7;
+    return options;
+}
+
+/**
+ * @brief Gets one of the NETWORKS, loading it the first time.
+ *
+ * @param name The name of the network.
+ * @return The graph.
+ */
+static Graph& getNetwork(const std::string& name) {
+    static std::map<std::string, std::unique_ptr<Graph>> networks;
+    std::unique_ptr<Graph>& graph = networks[name];
+    if (graph != nullptr) return *graph;
+
+    graph.reset(new Graph());
+    graph->setCacheCapacity(0);
+    if (name == "dataset") {
+        graph->setDatasetDirectory(TEST_DATASET_DIRECTORY);
+        graph->readStations();
+        graph->readNetwork();
+    }
+    else {
+        Topology topology;
+        parseTopology(name, topology);
+        NetworkGenerator(smallNetwork(topology)).fill(*graph);
+    }
+    return *graph;
+}
+
+/**
+ * @brief Draws pairs of different stations, always the same for the same network.
+ *
+ * @param numStations The number of stations.
+ * @return The pairs of ids.
+ */
+static std::vector<std::pair<int, int>> samplePairs(int numStations) {
+    std::mt19937 rng(42);
+    std::vector<std::pair<int, int>> pairs;
+    while ((int) pairs.size() < NUM_PAIRS) {
+        int s = (int) (rng() % (unsigned) numStations);
+        int t = (int) (rng() % (unsigned) numStations);
+        if (s != t) pairs.emplace_back(s, t);
+    }
+    return pairs;
+}
+
+/**
+ * @brief Checks that the three max flow engines find the same flow, from one station and from the leaves.
+ */
+static void testMaxFlowEngines(const std::string& network) {
+    Graph& graph = getNetwork(network);
+    const CSRGraph& csr = graph.getSnapshot();
+    REQUIRE(csr.getNumStations() > 1, network);
+
+    std::unique_ptr<MaxFlowEngine> edmondsKarp(MaxFlowEngine::create(EDMONDS_KARP));
+    std::unique_ptr<MaxFlowEngine> dinic(MaxFlowEngine::create(DINIC));
+    std::unique_ptr<MaxFlowEngine> pushRelabel(MaxFlowEngine::create(PUSH_RELABEL));
+    for (auto& pair : samplePairs(csr.getNumStations())) {
+        double flow = edmondsKarp->maxFlow(csr, pair.first, pair.second);
+        CHECK(sameFlow(flow, dinic->maxFlow(csr, pair.first, pair.second)), network << " " << pair.first << " -> " << pair.second);
+        CHECK(sameFlow(flow, pushRelabel->maxFlow(csr, pair.first, pair.second)), network << " " << pair.first << " -> " << pair.second);
+    }
+
+    //com varias origens, como no maxFlowGridToStation
+    const std::vector<int>& leaves = graph.getLeaves();
+    for (int t = 0; t < csr.getNumStations(); t += csr.getNumStations() / 10) {
+        double flow = edmondsKarp->maxFlow(csr, leaves, t);
+        CHECK(sameFlow(flow, dinic->maxFlow(csr, leaves, t)), network << " leaves -> " << t);
+        CHECK(sameFlow(flow, pushRelabel->maxFlow(csr, leaves, t)), network << " leaves -> " << t);
+    }
+}
+
+/**
+ * @brief Checks that the Gomory-Hu tree answers the same as a max flow on the snapshot.
+ */
+static void testGomoryHuTree(const std::string& network) {
+    Graph& graph = getNetwork(network);
+    const CSRGraph& csr = graph.getSnapshot();
+    const GomoryHuTree* tree = graph.getGomoryHuTree();
+    REQUIRE(tree != nullptr, network);
+
+    std::unique_ptr<MaxFlowEngine> engine(MaxFlowEngine::create(EDMONDS_KARP));
+    for (auto& pair : samplePairs(csr.getNumStations())) {
+        //a arvore devolve -1 para estacoes que nao estao ligadas, como o Graph
+        double flow = csr.dfs(pair.first, pair.second, SERVICE_ALL) ? engine->maxFlow(csr, pair.first, pair.second) : -1;
+        CHECK(sameFlow(tree->maxFlow(pair.first, pair.second), flow), network << " " << pair.first << " -> " << pair.second);
+    }
+}
+
+/**
+ * @brief Checks that removing lines from an IncrementalMaxFlow gives the same flow as computing it without them.
+ */
+static void testIncrementalMaxFlow(const std::string& network) {
+    Graph& graph = getNetwork(network);
+    const CSRGraph& csr = graph.getSnapshot();
+    std::unique_ptr<MaxFlowEngine> engine(MaxFlowEngine::create(EDMONDS_KARP));
+    std::mt19937 rng(1);
+
+    for (auto& pair : samplePairs(csr.getNumStations())) {
+        double flow = engine->maxFlow(csr, pair.first, pair.second);
+        IncrementalMaxFlow whatIf(csr, pair.first, pair.second);
+        REQUIRE(sameFlow(whatIf.getMaxFlow(), flow), network << " " << pair.first << " -> " << pair.second);
+
+        //remove algumas linhas ao acaso e compara com o fluxo calculado de raiz sem elas
+        std::vector<int> excluded;
+        for (int k = 0; k < 3; k++) {
+            int e = (int) (rng() % (unsigned) csr.getNumLines());
+            int u = csr.getTarget(csr.getReverse(e)), v = csr.getTarget(e);
+            //o removeLine remove a primeira linha entre as estacoes
+            int first = csr.begin(u);
+            while (csr.getTarget(first) != v) first++;
+            if (!whatIf.removeLine(u, v)) continue;
+            excluded.push_back(first);
+            IncrementalMaxFlow recomputed(csr, pair.first, pair.second, excluded);
+            CHECK(sameFlow(whatIf.getMaxFlow(), recomputed.getMaxFlow()),
+                  network << " " << pair.first << " -> " << pair.second << " without " << excluded.size() << " lines");
+        }
+
+        whatIf.restoreLines();
+        CHECK(sameFlow(whatIf.getMaxFlow(), flow), network << " " << pair.first << " -> " << pair.second << " restored");
+    }
+}
+
+/**
+ * @brief Checks that a contraction hierarchy survives being saved and loaded, and finds paths of the same cost as the
+ * PathEngine.
+ */
+static void testContractionHierarchy(const std::string& network) {
+    Graph& graph = getNetwork(network);
+    const CSRGraph& csr = graph.getSnapshot();
+    TemporaryDirectory directory;
+    std::string path = (directory.getPath() / "standard.ch").string();
+
+    REQUIRE(ContractionHierarchy(csr, SERVICE_STANDARD).save(path), network);
+    ContractionHierarchy hierarchy;
+    REQUIRE(hierarchy.load(path, csr, SERVICE_STANDARD), network);
+    CHECK(!ContractionHierarchy().load(path, csr, SERVICE_ALFA_PENDULAR), network);
+
+    //os caminhos podem ser diferentes quando ha empates, por isso so o custo e comparado
+    auto cost = [&csr](const std::vector<int>& lines) {
+        double sum = 0;
+        for (int e : lines) sum += csr.getCapacity(e);
+        return sum;
+    };
+    PathEngine paths(csr);
+    ContractionHierarchy::Search search;
+    std::vector<int> expected, found;
+    for (auto& pair : samplePairs(csr.getNumStations())) {
+        bool exists = paths.shortestPath(pair.first, pair.second, SERVICE_STANDARD, expected);
+        REQUIRE(exists == hierarchy.shortestPath(pair.first, pair.second, found, search),
+                network << " " << pair.first << " -> " << pair.second);
+        if (!exists) continue;
+        CHECK(sameFlow(cost(expected), cost(found)), network << " " << pair.first << " -> " << pair.second);
+        REQUIRE(!found.empty(), network << " " << pair.first << " -> " << pair.second);
+        CHECK(csr.getTarget(csr.getReverse(found.front())) == pair.first, network << " " << pair.first << " -> " << pair.second);
+        CHECK(csr.getTarget(found.back()) == pair.second, network << " " << pair.first << " -> " << pair.second);
+    }
+}
+
+/**
+ * @brief Checks that two graphs have the same stations and lines, in the same order.
+ */
+static void checkSameGraph(const Graph& expected, const Graph& actual, const std::string& context) {
+    const std::vector<Station*>& stations = expected.getStationSet();
+    REQUIRE(stations.size() == actual.getStationSet().size(), context);
+    for (std::size_t v = 0; v < stations.size(); v++) {
+        const Station* a = stations[v];
+        const Station* b = actual.getStationSet()[v];
+        REQUIRE(a->getName() == b->getName(), context << " station " << v);
+        CHECK(a->getDistrict() == b->getDistrict(), context << " " << a->getName());
+        CHECK(a->getMunicipality() == b->getMunicipality(), context << " " << a->getName());
+        CHECK(a->getTownShip() == b->getTownShip(), context << " " << a->getName());
+        CHECK(a->getLine() == b->getLine(), context << " " << a->getName());
+        REQUIRE(a->getAdj().size() == b->getAdj().size(), context << " " << a->getName());
+        for (std::size_t i = 0; i < a->getAdj().size(); i++) {
+            CHECK(a->getAdj()[i]->getDest()->getName() == b->getAdj()[i]->getDest()->getName(), context << " " << a->getName());
+            CHECK(a->getAdj()[i]->getCapacity() == b->getAdj()[i]->getCapacity(), context << " " << a->getName());
+            CHECK(a->getAdj()[i]->getService() == b->getAdj()[i]->getService(), context << " " << a->getName());
+        }
+    }
+}
+
+/**
+ * @brief Reads the csv files of a directory, converts them into the binary dataset and checks that loading it gives
+ * the same graph.
+ */
+static void checkBinaryRoundTrip(const std::filesystem::path& directory, const std::string& context) {
+    Graph parsed;
+    parsed.setDatasetDirectory(directory.string());
+    parsed.readStations();
+    parsed.readNetwork();
+    REQUIRE(!parsed.getStationSet().empty(), context);
+    REQUIRE(parsed.saveBinaryDataset(), context);
+
+    Graph loaded;
+    loaded.setDatasetDirectory(directory.string());
+    DatasetFingerprint source = fingerprintDataset(loaded.getDatasetPath(STATIONS_FILE_NAME), loaded.getDatasetPath(NETWORK_FILE_NAME));
+    REQUIRE(readBinaryDataset(loaded, loaded.getDatasetPath(BINARY_DATASET_NAME), source), context);
+    checkSameGraph(parsed, loaded, context);
+    CHECK(parsed.getSnapshot().checksum() == loaded.getSnapshot().checksum(), context);
+}
+
+/**
+ * @brief Checks that the binary dataset refuses a corrupted file and a file converted from other csv files.
+ */
+static void checkBinaryValidation() {
+    TemporaryDirectory directory;
+    copyDataset(directory.getPath());
+    Graph parsed;
+    parsed.setDatasetDirectory(directory.getPath().string());
+    parsed.readStations();
+    parsed.readNetwork();
+    REQUIRE(parsed.saveBinaryDataset(), "dataset");
+
+    std::string binaryPath = parsed.getDatasetPath(BINARY_DATASET_NAME);
+    std::string networkPath = parsed.getDatasetPath(NETWORK_FILE_NAME);
+    DatasetFingerprint source = fingerprintDataset(parsed.getDatasetPath(STATIONS_FILE_NAME), networkPath);
+
+    //um byte trocado no fim do ficheiro falha a soma de controlo
+    std::string contents;
+    {
+        std::ifstream file(binaryPath, std::ios::binary);
+        std::ostringstream bytes;
+        bytes << file.rdbuf();
+        contents = bytes.str();
+    }
+    REQUIRE(!contents.empty(), "dataset");
+    std::string corrupted = contents;
+    corrupted.back() ^= 1;
+    std::ofstream(binaryPath, std::ios::binary | std::ios::trunc) << corrupted;
+    Graph fromCorrupted;
+    CHECK(!readBinaryDataset(fromCorrupted, binaryPath, source), "corrupted");
+    CHECK(fromCorrupted.getStationSet().empty(), "corrupted");
+
+    //o ficheiro intacto volta a ser aceite, ate os ficheiros csv mudarem
+    std::ofstream(binaryPath, std::ios::binary | std::ios::trunc) << contents;
+    Graph fromIntact;
+    CHECK(readBinaryDataset(fromIntact, binaryPath, source), "intact");
+    std::ofstream(networkPath, std::ios::app) << "\n";
+    DatasetFingerprint changed = fingerprintDataset(parsed.getDatasetPath(STATIONS_FILE_NAME), networkPath);
+    Graph fromStale;
+    CHECK(!readBinaryDataset(fromStale, binaryPath, changed), "stale");
+}
+
+/**
+ * @brief Checks the csv -> binary -> load round trip on the dataset and on the synthetic networks, and the validation
+ * of the binary file.
+ */
+static void testBinaryDataset() {
+    {
+        TemporaryDirectory directory;
+        copyDataset(directory.getPath());
+        checkBinaryRoundTrip(directory.getPath(), "dataset");
+    }
+    for (Topology topology : {TOPOLOGY_TREE, TOPOLOGY_MESH, TOPOLOGY_RING}) {
+        TemporaryDirectory directory;
+        CHECK(NetworkGenerator(smallNetwork(topology)).write(directory.getPath().string()), "topology " << topology);
+        checkBinaryRoundTrip(directory.getPath(), "topology " + std::to_string(topology));
+    }
+    checkBinaryValidation();
+}
+
+/**
+ * @brief Checks the quotes, the line endings and the byte order mark of the csv parser.
+ */
+static void testCSVReader() {
+    std::istringstream in("\xEF\xBB\xBF" "a,\"b, c\",d\r\n"
+                          "\r\n"
+                          "\"multi\nline\",\"say \"\"hi\"\"\",\r\n"
+                          "\"open,x\n"
+                          "last,row");
+    CSVReader reader(in, "test");
+    std::vector<std::string_view> fields;
+
+    REQUIRE(reader.readRow(fields), "first row");
+    CHECK(reader.getLineNumber() == 1, reader.getLineNumber());
+    REQUIRE(fields.size() == 3, fields.size());
+    CHECK(fields[0] == "a", fields[0]);
+    CHECK(fields[1] == "b, c", fields[1]);
+    CHECK(fields[2] == "d", fields[2]);
+
+    REQUIRE(reader.readRow(fields), "second row");
+    CHECK(reader.getLineNumber() == 3, reader.getLineNumber());
+    REQUIRE(fields.size() == 3, fields.size());
+    CHECK(fields[0] == "multi\nline", fields[0]);
+    CHECK(fields[1] == "say \"hi\"", fields[1]);
+    CHECK(fields[2].empty(), fields[2]);
+
+    //as aspas por fechar estragam o resto do ficheiro, que e ignorado
+    CHECK(!reader.readRow(fields), "unterminated quote");
+
+    double value;
+    CHECK(parseDouble(" 12.5 ", value) && value == 12.5, value);
+    CHECK(!parseDouble("12x", value), "12x");
+    CHECK(!parseDouble("", value), "empty");
+}
+
+/**
+ * @brief Checks the framing of the messages of the query server over a pair of connected sockets.
+ */
+static void testSocketIO() {
+    int sockets[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, sockets) == 0, "socketpair");
+
+    std::string payload;
+    for (const std::string& sent : {std::string("maxflow,Porto Campanhã,Lisboa Oriente"), std::string(),
+                                    std::string(100000, 'x')}) {
+        CHECK(writeFrame(sockets[0], sent), sent.size());
+        CHECK(readFrame(sockets[1], payload) && payload == sent, sent.size());
+    }
+
+    //uma trama maior do que MAX_FRAME_SIZE e recusada
+    std::uint32_t size = MAX_FRAME_SIZE + 1;
+    unsigned char header[4] = {(unsigned char) (size >> 24), (unsigned char) (size >> 16), (unsigned char) (size >> 8), (unsigned char) size};
+    CHECK(write(sockets[0], header, sizeof(header)) == (ssize_t) sizeof(header), "header");
+    CHECK(!readFrame(sockets[1], payload), "oversized frame");
+
+    //a outra ponta fechada acaba a leitura
+    closeSocket(sockets[0]);
+    CHECK(!readFrame(sockets[1], payload), "closed socket");
+    closeSocket(sockets[1]);
+}
+
+/**
+ * @brief Runs the test named in the arguments (one of the names registered with ctest), or every test.
+ */
+int main(int argc, char* argv[]) {
+    auto onEveryNetwork = [](void (*test)(const std::string&)) {
+        return [test]() {
+            for (const char* network : NETWORKS) test(network);
+        };
+    };
+    std::vector<std::pair<std::string, std::function<void()>>> tests = {
+            {"max-flow-engines", onEveryNetwork(testMaxFlowEngines)},
+            {"gomory-hu-tree", onEveryNetwork(testGomoryHuTree)},
+            {"incremental-max-flow", onEveryNetwork(testIncrementalMaxFlow)},
+            {"contraction-hierarchy", onEveryNetwork(testContractionHierarchy)},
+            {"binary-dataset", testBinaryDataset},
+            {"csv-reader", testCSVReader},
+            {"socket-io", testSocketIO},
+    };
+
+    bool found = false;
+    for (auto& test : tests) {
+        if (argc > 1 && test.first != argv[1]) continue;
+        found = true;
+        int before = failures;
+        test.second();
+        std::cout << test.first << ": " << (failures == before ? "passed" : "FAILED") << std::endl;
+    }
+    if (!found) {
+        std::cerr << "Unknown test: " << argv[1] << std::endl;
+        return 1;
+    }
+    return failures == 0 ? 0 : 1;
+}